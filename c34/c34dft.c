@@ -188,15 +188,37 @@ static void init_dft() {
 }
 
 
-static float dft_k(int k) {
+/* sliding DFT, nur die Ton-Bins k0,k1 (statt dft_k() ueber N je Sample):
+   Hann(WLEN): h[j] = 1/2 - 1/4 e^{+ibj} - 1/4 e^{-ibj}, b = 2pi/(WLEN-1),
+   je Ton 3 laufende Summen mit absoluter Phase e^{-i2pi kn/N} e^{+-ibn}
+*/
+static float complex   eb[WLEN-1];
+static float complex   sc[2][3][WLEN];  // Summanden im Fenster
+static double complex  sA[2][3];        // laufende Summen
+static unsigned int    sn;
+
+static void init_sdft() {
     int n;
-    float complex  Zk;
+    for (n = 0; n < WLEN-1; n++)  eb[n] = cexp( I*2*M_PI * n / (float)(WLEN-1) );
+}
 
-    Zk = 0;
-    for (n = 0; n < N; n++) {
-        Zk += xn[n] * ew[k*n];
+static float sdft_k(int t, int k, float x) {  // |Z_k|^2, Fenster x[sn-WLEN+1..sn]
+    int j = sn % WLEN;
+    float complex  b = eb[sn % (WLEN-1)];    // Fensteranfang sn-(WLEN-1) = sn mod (WLEN-1)
+    float complex  c[3], z;
+    int i;
+
+    c[0] = x * ew[(k*sn) % N];
+    c[1] = c[0] * b;
+    c[2] = c[0] * conj(b);
+    for (i = 0; i < 3; i++) {
+        sA[t][i] -= sc[t][i][j];
+        sA[t][i] += c[i];
+        sc[t][i][j] = c[i];
     }
-    return cabs(Zk);
+    z = 0.5*sA[t][0] - 0.25*conj(b)*sA[t][1] - 0.25*b*sA[t][2];
+
+    return crealf(z)*crealf(z) + cimagf(z)*cimagf(z);
 }
 
 static void dft() {
@@ -252,12 +274,13 @@ static void dft2() {
 
 static int max_bin() {
     int k, kmax;
-    float max;
+    float max, m;
 
     max = 0; kmax = 0;
     for (k = 0; k < N/2-1; k++) {
-        if (cabs(Z[k]) > max) {
-            max = cabs(Z[k]);
+        m = crealf(Z[k])*crealf(Z[k]) + cimagf(Z[k])*cimagf(Z[k]);
+        if (m > max) {
+            max = m;
             kmax = k;
         }
     }
@@ -512,12 +535,13 @@ int main(int argc, char *argv[]) {
     int sample;
     int i, j, kmax, k0, k1;
     int bit = 8, bit0 = 8;
-    int pos = 0, pos0 = 0;
+    double pos = 0, pos0 = 0;
     int header_found = 0;
-    int bitlen; // sample_rate/BAUD_RATE
+    float bitlen; // sample_rate/BAUD_RATE
     int len;
     float k_f0, k_f1, k_df;
     float cb0, cb1;
+    float d = 0, d0 = 0;  // soft: (cb1-cb0)/(cb1+cb0)
     int cfreq = -1;
 
     fpname = argv[0];
@@ -580,7 +604,7 @@ int main(int argc, char *argv[]) {
     }
 
 
-    bitlen = sample_rate/BAUD_RATE;
+    bitlen = sample_rate/(float)BAUD_RATE;
     k_f0 = freq2bin(4700);  // bit0: 4800Hz
     k_f1 = freq2bin(2900);  // bit1: 3000Hz
     k_df = fabs(k_f0-k_f1)/2.5;
@@ -588,6 +612,7 @@ int main(int argc, char *argv[]) {
     k1 = (int)(k_f1+.5);
 
     init_dft();
+    init_sdft();
 
     ptr = -1; sample_count = -1;
     while ((sample=read_signed_sample(fp)) < EOF_INT) {
@@ -597,14 +622,19 @@ int main(int argc, char *argv[]) {
         if (ptr == N) ptr = 0;
         buffer[ptr] = sample / (float)(1<<bits_sample);
 
+        if (!option_dft) {
+            cb0 = sdft_k(0, k0, buffer[ptr]);
+            cb1 = sdft_k(1, k1, buffer[ptr]);
+            sn++;
+        }
+
         if (sample_count < N) continue;
 
 
-            for (j = 0; j < N; j++) {
-                xn[j] = Hann[j]*buffer[(ptr + j + 1)%N];
-            }
-
             if (option_dft) {
+                for (j = 0; j < N; j++) {
+                    xn[j] = Hann[j]*buffer[(ptr + j + 1)%N];
+                }
                 if (option_dft == 2) dft2();
                 else                 dft();
                 kmax = max_bin();
@@ -612,8 +642,8 @@ int main(int argc, char *argv[]) {
                 else if (kmax > k_f1-k_df  &&  kmax < k_f1+k_df)  bit = 1;  // kmax = freq2bin(3000): 3000Hz
             }
             else {
-                cb0 = dft_k(k0);
-                cb1 = dft_k(k1);
+                d0 = d;
+                d = cb0+cb1 > 0 ? (cb1-cb0)/(cb1+cb0) : 0;
                 if      ( cb0 > cb1 )  bit = 0;  // freq2bin(4800) : 4800Hz
                 else                   bit = 1;  // freq2bin(3000) : 3000Hz
             }
@@ -622,8 +652,9 @@ int main(int argc, char *argv[]) {
 
                 pos0 = pos;
                 pos = sample_count;  //sample_count-(N-1)/2
+                if (d != d0) pos -= d/(d-d0);  // soft Nulldurchgang zwischen den Samples
 
-                len = (pos-pos0+bitlen/2)/bitlen; //(pos-pos0)/bitlen + 0.5;
+                len = (pos-pos0)/bitlen + 0.5;
                 for (i = 0; i < len; i++) {
                     inc_bufpos();
                     buf[bufpos] = 0x30 + bit0;
@@ -286,11 +286,11 @@ static ui8_t log_11B[256] = {  // 0x11B: log_a , a = 0x03 = X+1
   0x44, 0x11, 0x92, 0xD9, 0x23, 0x20, 0x2E, 0x89, 0xB4, 0x7C, 0xB8, 0x26, 0x77, 0x99, 0xE3, 0xA5,
   0x67, 0x4A, 0xED, 0xDE, 0xC5, 0x31, 0xFE, 0x18, 0x0D, 0x63, 0x8C, 0x80, 0xC0, 0xF7, 0x70, 0x07};
 
-// ------------------------------------------------------------------------------------------------
+*/
 
 // F2[X] mod X^8 + X^4 + X^3 + X^2 + 1
 
-static ui8_t exp_11D[256] = {  // 0x11D: a^n , a = 0x02 = X
+static const ui8_t exp_11D[256] = {  // 0x11D: a^n , a = 0x02 = X
   0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1D, 0x3A, 0x74, 0xE8, 0xCD, 0x87, 0x13, 0x26,
   0x4C, 0x98, 0x2D, 0x5A, 0xB4, 0x75, 0xEA, 0xC9, 0x8F, 0x03, 0x06, 0x0C, 0x18, 0x30, 0x60, 0xC0,
   0x9D, 0x27, 0x4E, 0x9C, 0x25, 0x4A, 0x94, 0x35, 0x6A, 0xD4, 0xB5, 0x77, 0xEE, 0xC1, 0x9F, 0x23,
@@ -308,7 +308,7 @@ static ui8_t exp_11D[256] = {  // 0x11D: a^n , a = 0x02 = X
   0x12, 0x24, 0x48, 0x90, 0x3D, 0x7A, 0xF4, 0xF5, 0xF7, 0xF3, 0xFB, 0xEB, 0xCB, 0x8B, 0x0B, 0x16,
   0x2C, 0x58, 0xB0, 0x7D, 0xFA, 0xE9, 0xCF, 0x83, 0x1B, 0x36, 0x6C, 0xD8, 0xAD, 0x47, 0x8E, 0x01};
 
-static ui8_t log_11D[256] = {  // 0x11D: log_a , a = 0x02 = X
+static const ui8_t log_11D[256] = {  // 0x11D: log_a , a = 0x02 = X
   -00 , 0x00, 0x01, 0x19, 0x02, 0x32, 0x1A, 0xC6, 0x03, 0xDF, 0x33, 0xEE, 0x1B, 0x68, 0xC7, 0x4B,
   0x04, 0x64, 0xE0, 0x0E, 0x34, 0x8D, 0xEF, 0x81, 0x1C, 0xC1, 0x69, 0xF8, 0xC8, 0x08, 0x4C, 0x71,
   0x05, 0x8A, 0x65, 0x2F, 0xE1, 0x24, 0x0F, 0x21, 0x35, 0x93, 0x8E, 0xDA, 0xF0, 0x12, 0x82, 0x45,
@@ -328,20 +328,62 @@ static ui8_t log_11D[256] = {  // 0x11D: log_a , a = 0x02 = X
 
 // ------------------------------------------------------------------------------------------------
 
+// F2[X] mod X^8 + X^7 + X^2 + X + 1 : 0x187
+
+static const ui8_t exp_187[256] = {  // 0x187: a^n , a = 0x02 = X
+  0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x87, 0x89, 0x95, 0xAD, 0xDD, 0x3D, 0x7A, 0xF4,
+  0x6F, 0xDE, 0x3B, 0x76, 0xEC, 0x5F, 0xBE, 0xFB, 0x71, 0xE2, 0x43, 0x86, 0x8B, 0x91, 0xA5, 0xCD,
+  0x1D, 0x3A, 0x74, 0xE8, 0x57, 0xAE, 0xDB, 0x31, 0x62, 0xC4, 0x0F, 0x1E, 0x3C, 0x78, 0xF0, 0x67,
+  0xCE, 0x1B, 0x36, 0x6C, 0xD8, 0x37, 0x6E, 0xDC, 0x3F, 0x7E, 0xFC, 0x7F, 0xFE, 0x7B, 0xF6, 0x6B,
+  0xD6, 0x2B, 0x56, 0xAC, 0xDF, 0x39, 0x72, 0xE4, 0x4F, 0x9E, 0xBB, 0xF1, 0x65, 0xCA, 0x13, 0x26,
+  0x4C, 0x98, 0xB7, 0xE9, 0x55, 0xAA, 0xD3, 0x21, 0x42, 0x84, 0x8F, 0x99, 0xB5, 0xED, 0x5D, 0xBA,
+  0xF3, 0x61, 0xC2, 0x03, 0x06, 0x0C, 0x18, 0x30, 0x60, 0xC0, 0x07, 0x0E, 0x1C, 0x38, 0x70, 0xE0,
+  0x47, 0x8E, 0x9B, 0xB1, 0xE5, 0x4D, 0x9A, 0xB3, 0xE1, 0x45, 0x8A, 0x93, 0xA1, 0xC5, 0x0D, 0x1A,
+  0x34, 0x68, 0xD0, 0x27, 0x4E, 0x9C, 0xBF, 0xF9, 0x75, 0xEA, 0x53, 0xA6, 0xCB, 0x11, 0x22, 0x44,
+  0x88, 0x97, 0xA9, 0xD5, 0x2D, 0x5A, 0xB4, 0xEF, 0x59, 0xB2, 0xE3, 0x41, 0x82, 0x83, 0x81, 0x85,
+  0x8D, 0x9D, 0xBD, 0xFD, 0x7D, 0xFA, 0x73, 0xE6, 0x4B, 0x96, 0xAB, 0xD1, 0x25, 0x4A, 0x94, 0xAF,
+  0xD9, 0x35, 0x6A, 0xD4, 0x2F, 0x5E, 0xBC, 0xFF, 0x79, 0xF2, 0x63, 0xC6, 0x0B, 0x16, 0x2C, 0x58,
+  0xB0, 0xE7, 0x49, 0x92, 0xA3, 0xC1, 0x05, 0x0A, 0x14, 0x28, 0x50, 0xA0, 0xC7, 0x09, 0x12, 0x24,
+  0x48, 0x90, 0xA7, 0xC9, 0x15, 0x2A, 0x54, 0xA8, 0xD7, 0x29, 0x52, 0xA4, 0xCF, 0x19, 0x32, 0x64,
+  0xC8, 0x17, 0x2E, 0x5C, 0xB8, 0xF7, 0x69, 0xD2, 0x23, 0x46, 0x8C, 0x9F, 0xB9, 0xF5, 0x6D, 0xDA,
+  0x33, 0x66, 0xCC, 0x1F, 0x3E, 0x7C, 0xF8, 0x77, 0xEE, 0x5B, 0xB6, 0xEB, 0x51, 0xA2, 0xC3, 0x01};
+
+static const ui8_t log_187[256] = {  // 0x187: log_a , a = 0x02 = X
+  -00 , 0x00, 0x01, 0x63, 0x02, 0xC6, 0x64, 0x6A, 0x03, 0xCD, 0xC7, 0xBC, 0x65, 0x7E, 0x6B, 0x2A,
+  0x04, 0x8D, 0xCE, 0x4E, 0xC8, 0xD4, 0xBD, 0xE1, 0x66, 0xDD, 0x7F, 0x31, 0x6C, 0x20, 0x2B, 0xF3,
+  0x05, 0x57, 0x8E, 0xE8, 0xCF, 0xAC, 0x4F, 0x83, 0xC9, 0xD9, 0xD5, 0x41, 0xBE, 0x94, 0xE2, 0xB4,
+  0x67, 0x27, 0xDE, 0xF0, 0x80, 0xB1, 0x32, 0x35, 0x6D, 0x45, 0x21, 0x12, 0x2C, 0x0D, 0xF4, 0x38,
+  0x06, 0x9B, 0x58, 0x1A, 0x8F, 0x79, 0xE9, 0x70, 0xD0, 0xC2, 0xAD, 0xA8, 0x50, 0x75, 0x84, 0x48,
+  0xCA, 0xFC, 0xDA, 0x8A, 0xD6, 0x54, 0x42, 0x24, 0xBF, 0x98, 0x95, 0xF9, 0xE3, 0x5E, 0xB5, 0x15,
+  0x68, 0x61, 0x28, 0xBA, 0xDF, 0x4C, 0xF1, 0x2F, 0x81, 0xE6, 0xB2, 0x3F, 0x33, 0xEE, 0x36, 0x10,
+  0x6E, 0x18, 0x46, 0xA6, 0x22, 0x88, 0x13, 0xF7, 0x2D, 0xB8, 0x0E, 0x3D, 0xF5, 0xA4, 0x39, 0x3B,
+  0x07, 0x9E, 0x9C, 0x9D, 0x59, 0x9F, 0x1B, 0x08, 0x90, 0x09, 0x7A, 0x1C, 0xEA, 0xA0, 0x71, 0x5A,
+  0xD1, 0x1D, 0xC3, 0x7B, 0xAE, 0x0A, 0xA9, 0x91, 0x51, 0x5B, 0x76, 0x72, 0x85, 0xA1, 0x49, 0xEB,
+  0xCB, 0x7C, 0xFD, 0xC4, 0xDB, 0x1E, 0x8B, 0xD2, 0xD7, 0x92, 0x55, 0xAA, 0x43, 0x0B, 0x25, 0xAF,
+  0xC0, 0x73, 0x99, 0x77, 0x96, 0x5C, 0xFA, 0x52, 0xE4, 0xEC, 0x5F, 0x4A, 0xB6, 0xA2, 0x16, 0x86,
+  0x69, 0xC5, 0x62, 0xFE, 0x29, 0x7D, 0xBB, 0xCC, 0xE0, 0xD3, 0x4D, 0x8C, 0xF2, 0x1F, 0x30, 0xDC,
+  0x82, 0xAB, 0xE7, 0x56, 0xB3, 0x93, 0x40, 0xD8, 0x34, 0xB0, 0xEF, 0x26, 0x37, 0x0C, 0x11, 0x44,
+  0x6F, 0x78, 0x19, 0x9A, 0x47, 0x74, 0xA7, 0xC1, 0x23, 0x53, 0x89, 0xFB, 0x14, 0x5D, 0xF8, 0x97,
+  0x2E, 0x4B, 0xB9, 0x60, 0x0F, 0xED, 0x3E, 0xE5, 0xF6, 0x87, 0xA5, 0x17, 0x3A, 0xA3, 0x3C, 0xB7};
+
+// ------------------------------------------------------------------------------------------------
+
 // F2[X] mod X^6 + X + 1 : 0x43
 
-static ui8_t exp64[64] = {  // 0x43: a^n , a = 0x02 = X
+static const ui8_t exp64[64] = {  // 0x43: a^n , a = 0x02 = X
   0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x03, 0x06, 0x0C, 0x18, 0x30, 0x23, 0x05, 0x0A, 0x14, 0x28,
   0x13, 0x26, 0x0F, 0x1E, 0x3C, 0x3B, 0x35, 0x29, 0x11, 0x22, 0x07, 0x0E, 0x1C, 0x38, 0x33, 0x25,
   0x09, 0x12, 0x24, 0x0B, 0x16, 0x2C, 0x1B, 0x36, 0x2F, 0x1D, 0x3A, 0x37, 0x2D, 0x19, 0x32, 0x27,
   0x0D, 0x1A, 0x34, 0x2B, 0x15, 0x2A, 0x17, 0x2E, 0x1F, 0x3E, 0x3F, 0x3D, 0x39, 0x31, 0x21, 0x01};
 
-static ui8_t log64[64] = {
+static const ui8_t log64[64] = {
   -00 , 0x00, 0x01, 0x06, 0x02, 0x0C, 0x07, 0x1A, 0x03, 0x20, 0x0D, 0x23, 0x08, 0x30, 0x1B, 0x12,
   0x04, 0x18, 0x21, 0x10, 0x0E, 0x34, 0x24, 0x36, 0x09, 0x2D, 0x31, 0x26, 0x1C, 0x29, 0x13, 0x38,
   0x05, 0x3E, 0x19, 0x0B, 0x22, 0x1F, 0x11, 0x2F, 0x0F, 0x17, 0x35, 0x33, 0x25, 0x2C, 0x37, 0x28,
   0x0A, 0x3D, 0x2E, 0x1E, 0x32, 0x16, 0x27, 0x2B, 0x1D, 0x3C, 0x2A, 0x15, 0x14, 0x3B, 0x39, 0x3A};
 
+/*
+
 // ------------------------------------------------------------------------------------------------
 
 // F2[X] mod X^4 + X + 1 : 0x13
@@ -635,15 +677,60 @@ static int era_sigma(RS_t *RS, int n, ui8_t era_pos[], ui8_t *sigma) {
     return 0;
 }
 
+// gT[c][j] = c*g[j] : Division durch g(X) ohne GF_mul
+static int rs_gtab(RS_t *RS) {
+    GF_t *gf = &RS->GF;
+    int c, j;
+
+    if (RS->R > MAX_GTR) return -1;
+
+    for (c = 0; c < 256; c++) {
+        for (j = 0; j < MAX_GTR; j++) {
+            RS->gT[c][j] = (c < gf->ord && j < RS->R) ? GF_mul(gf, (ui8_t)c, RS->g[j]) : 0;
+        }
+    }
+    return 0;
+}
+
+// r(X) = cw(X) mod g(X), g monic, deg g = R
+// return 0: r=0 , d.h. cw Codewort
+static int rs_rem(RS_t *RS, ui8_t cw[], ui8_t *r) {
+    int n, j, R = RS->R;
+    ui8_t fb, *gc;
+    ui8_t c = 0;
+    ui8_t buf[MAX_DEG+1];
+
+    for (n = 0; n < RS->N; n++) buf[n] = cw[n];
+
+    for (n = RS->N-1; n >= R; n--) {
+        fb = buf[n];
+        gc = RS->gT[fb];
+        for (j = 0; j < R; j++) buf[n-R+j] ^= gc[j];
+    }
+
+    for (j = 0; j < R; j++) {
+        r[j] = buf[j];
+        c |= buf[j];
+    }
+    return c != 0;
+}
+
 static int syndromes(RS_t *RS, ui8_t cw[], ui8_t *S) {
     GF_t *gf = &RS->GF;
-    int i, errors = 0;
-    ui8_t a_i;
+    int i, n, errors = 0;
+    ui8_t a_i, y;
+    ui8_t r[MAX_DEG+1];
+
+    // cw(X) = q(X)g(X) + r(X) , g((alpha^p)^(b+i)) = 0
+    // meist r=0, sonst S_i = r((alpha^p)^(b+i)) , deg r < R
+    if (rs_rem(RS, cw, r) == 0) return 0;
 
     // syndromes: e_j=S((alpha^p)^(b+i))  (wie in g(X))
     for (i = 0; i < 2*RS->t; i++) {
         a_i = gf->exp_a[(RS->p*(RS->b+i)) % (gf->ord-1)];  // (alpha^p)^(b+i)
-        S[i] = poly_eval(gf, cw, a_i);
+        y = r[RS->R-1];
+        for (n = RS->R-2; n >= 0; n--) y = GF_mul(gf, y, a_i) ^ r[n];
+        S[i] = y;
         if (S[i]) errors = 1;
     }
     return errors;
@@ -728,6 +815,8 @@ int rs_init_RS255(RS_t *RS) {
         poly_mul(gf, RS->g, Xalp, RS->g);
     }
 
+    if (rs_gtab(RS) < 0) return -1;
+
     return check_gen;
 }
 
@@ -779,6 +868,8 @@ int rs_init_RS255ccsds(RS_t *RS) {
     RS.g[15] = RS.g[17] = exp_a[5];
     RS.g[16] = exp_a[24];
 */
+    if (rs_gtab(RS) < 0) return -1;
+
     return check_gen;
 }
 
@@ -797,6 +888,8 @@ int rs_init_BCH64(RS_t *RS) {
     //     =(X^6+X+1)(X^6+X^4+X^2+X+1)
     RS->g[0] = RS->g[3] = RS->g[4] = RS->g[5] = RS->g[8] = RS->g[10] = RS->g[12] = 1;
 
+    if (rs_gtab(RS) < 0) return -1;
+
     return check_gen;
 }
 
@@ -822,6 +915,8 @@ int rs_init_RS15ccsds(RS_t *RS) {
         poly_mul(gf, RS->g, Xalp, RS->g);
     }
 
+    if (rs_gtab(RS) < 0) return -1;
+
     return check_gen;
 }
 
@@ -926,13 +1021,267 @@ int rs_decode_ErrEra(RS_t *RS, ui8_t cw[], int nera, ui8_t era_pos[],
     return errera;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/*
+ *  feste Codes: GF(2^m), N, R, b, p als Konstanten, exp/log const Tabellen
+ *  (RS255: RS41, RS92 ; RS255ccsds: LMS6 ; BCH64: Meisei)
+ *  rs_dec_spec()/bch_dec_spec() inline mit konstanten Parametern,
+ *  Polynome nur bis Grad R statt MAX_DEG;
+ *  gleiche Rechnung wie rs_decode_ErrEra()/rs_decode_bch_gf2t2() (nera=0)
+ */
+
+#define RSS_DEG 64  // >= 2*R
+
+static inline ui8_t gfs_mul(const ui8_t *ex, const ui8_t *lg, const int n, ui8_t a, ui8_t c) {
+    int x;
+    if (a == 0 || c == 0) return 0;
+    x = lg[a] + lg[c]; if (x >= n) x -= n;  // a^n = 1
+    return ex[x];
+}
+
+static inline ui8_t gfs_inv(const ui8_t *ex, const ui8_t *lg, const int n, ui8_t a) {
+    if (a == 0) return 0;  // DIV_BY_ZERO
+    return ex[n-lg[a]];
+}
+
+static inline int polys_deg(ui8_t p[], int d) {
+    while (d >= 0 && p[d] == 0) d--;  // deg(0) = -1
+    return d;
+}
+
+static inline ui8_t polys_eval(const ui8_t *ex, const ui8_t *lg, const int n, ui8_t p[], int d, ui8_t x) {
+    int i;
+    ui8_t y = 0;
+    for (i = d; i >= 0; i--) y = gfs_mul(ex, lg, n, y, x) ^ p[i];
+    return y;
+}
+
+// S(x)Lambda(x) = Omega(x) mod x^R , wie polyGF_lfsr(): deg Omega < t
+static inline void polys_lfsr(const ui8_t *ex, const ui8_t *lg, const int n, const int t, const int R,
+                              ui8_t S[], ui8_t *Lambda, ui8_t *Omega) {
+    int i, j, d0, d1, ds0, ds1, dq;
+    ui8_t r0[RSS_DEG+1], r1[RSS_DEG+1], s0[RSS_DEG+1], s1[RSS_DEG+1], quo[RSS_DEG+1];
+    ui8_t c, ilc, tmp;
+
+    for (i = 0; i <= RSS_DEG; i++) { r0[i] = 0; r1[i] = 0; s0[i] = 0; s1[i] = 0; }
+    for (i = 0; i < R; i++) r0[i] = S[i];
+    r1[R] = 1; // x^R
+    s0[0] = 1;
+    d0 = polys_deg(r0, R); d1 = R;
+    ds0 = 0; ds1 = -1;
+
+    while (d1 >= t) {
+        // r0 = quo*r1 + r2 , r2 -> r0
+        for (i = 0; i <= RSS_DEG; i++) quo[i] = 0;
+        dq = -1;
+        ilc = gfs_inv(ex, lg, n, r1[d1]);
+        while (d0 >= d1) {
+            c = gfs_mul(ex, lg, n, r0[d0], ilc);
+            quo[d0-d1] = c; if (dq < d0-d1) dq = d0-d1;
+            for (i = 0; i <= d1; i++) r0[d0-d1+i] ^= gfs_mul(ex, lg, n, r1[i], c);
+            d0 = polys_deg(r0, d0);
+        }
+        // s2 = quo*s1 + s0 -> s0
+        for (i = 0; i <= dq; i++) {
+            if (quo[i] == 0) continue;
+            for (j = 0; j <= ds1; j++) s0[i+j] ^= gfs_mul(ex, lg, n, quo[i], s1[j]);
+        }
+        ds0 = polys_deg(s0, RSS_DEG);
+        // swap: (r0,r1) = (r1,r2) , (s0,s1) = (s1,s2)
+        for (i = 0; i <= RSS_DEG; i++) {
+            tmp = r0[i]; r0[i] = r1[i]; r1[i] = tmp;
+            tmp = s0[i]; s0[i] = s1[i]; s1[i] = tmp;
+        }
+        i = d0; d0 = d1; d1 = i;
+        i = ds0; ds0 = ds1; ds1 = i;
+    }
+
+    for (i = 0; i <= RSS_DEG; i++) { Omega[i] = r1[i]; Lambda[i] = s1[i]; }
+}
+
+// RS(N, N-R), 2t=R, nur Fehler (keine Erasures)
+static inline int rs_dec_spec(RS_t *RS, ui8_t cw[], ui8_t *err_pos, ui8_t *err_val,
+                              const ui8_t *ex, const ui8_t *lg, const int n,
+                              const int R, const int b, const int p, const int ip) {
+    const int t = R/2;
+    ui8_t r[RSS_DEG+1], S[RSS_DEG+1],
+          Lambda[RSS_DEG+1], Omega[RSS_DEG+1], DLam[RSS_DEG+1];
+    ui8_t x, x1, y, w, z, Y, gamma;
+    int deg_Lambda, deg_Omega;
+    int i, j, nerr;
+
+    for (i = 0; i < R; i++) { err_pos[i] = 0; }
+    for (i = 0; i < R; i++) { err_val[i] = 0; }
+
+    if (rs_rem(RS, cw, r) == 0) return 0;
+
+    // S_i = r((alpha^p)^(b+i))
+    for (i = 0; i < R; i++) {
+        int la = (p*(b+i)) % n;
+        y = r[R-1];
+        for (j = R-2; j >= 0; j--) y = (y ? ex[(lg[y]+la) % n] : 0) ^ r[j];
+        S[i] = y;
+    }
+
+    polys_lfsr(ex, lg, n, t, R, S, Lambda, Omega);
+
+    deg_Lambda = polys_deg(Lambda, RSS_DEG);
+    deg_Omega  = polys_deg(Omega, RSS_DEG);
+    if (deg_Omega >= deg_Lambda) return -3;
+
+    gamma = Lambda[0];
+    if (gamma == 0) return -2;
+    gamma = gfs_inv(ex, lg, n, gamma);
+    for (i = deg_Lambda; i >= 0; i--) Lambda[i] = gfs_mul(ex, lg, n, Lambda[i], gamma);
+    for (i = deg_Omega ; i >= 0; i--)  Omega[i] = gfs_mul(ex, lg, n,  Omega[i], gamma);
+
+    for (i = 0; i <= RSS_DEG; i++) DLam[i] = 0;
+    for (i = 1; i <= deg_Lambda; i += 2) DLam[i-1] = Lambda[i];
+
+    nerr = 0;
+    for (i = 1; i <= n; i++) { // Lambda(0)=1
+        x = (ui8_t)i;
+        if (polys_eval(ex, lg, n, Lambda, deg_Lambda, x) == 0) {
+            x1 = gfs_inv(ex, lg, n, x);
+            err_pos[nerr] = (lg[x1]*ip) % n;
+            // forney()
+            w = polys_eval(ex, lg, n, Omega, deg_Omega, x);
+            z = polys_eval(ex, lg, n, DLam, deg_Lambda-1, x);
+            if (z == 0) Y = 0;
+            else {
+                Y = gfs_mul(ex, lg, n, w, gfs_inv(ex, lg, n, z));
+                if (b == 0) Y = gfs_mul(ex, lg, n, x1, Y);
+                else if (b > 1) Y = gfs_mul(ex, lg, n, ex[((b-1)*lg[x]) % n], Y);
+            }
+            err_val[nerr] = Y;
+            nerr++;
+        }
+        if (nerr >= deg_Lambda) break;
+    }
+
+    if (nerr < deg_Lambda) return -1; // uncorrectable errors
+    for (i = 0; i < nerr; i++) cw[err_pos[i]] ^= err_val[i];
+
+    return nerr;
+}
+
+// bin. BCH(63, 51), t=2, b=1 : wie rs_decode_bch_gf2t2()
+static int bch_dec_spec(RS_t *RS, ui8_t cw[], ui8_t *err_pos, ui8_t *err_val) {
+    const ui8_t *ex = exp64, *lg = log64;
+    const int n = 63, t = 2, R = 12;
+    ui8_t r[RSS_DEG+1], S[RSS_DEG+1],
+          Lambda[RSS_DEG+1], Omega[RSS_DEG+1];
+    ui8_t x, y, gamma, L1, L2;
+    int deg_Lambda, deg_Omega;
+    int i, j, nerr;
+
+    for (i = 0; i < t; i++) { err_pos[i] = 0; }
+    for (i = 0; i < t; i++) { err_val[i] = 0; }
+
+    if (rs_rem(RS, cw, r) == 0) return 0;
+
+    // S_i = r(alpha^(1+i)), i < 2t
+    for (i = 0; i < 2*t; i++) {
+        y = r[R-1];
+        for (j = R-2; j >= 0; j--) y = (y ? ex[(lg[y]+1+i) % n] : 0) ^ r[j];
+        S[i] = y;
+    }
+
+    polys_lfsr(ex, lg, n, t, 2*t, S, Lambda, Omega);
+
+    deg_Lambda = polys_deg(Lambda, RSS_DEG);
+    deg_Omega  = polys_deg(Omega, RSS_DEG);
+    gamma = Lambda[0];
+    if (gamma == 0) return -2;
+    gamma = gfs_inv(ex, lg, n, gamma);
+    for (i = deg_Lambda; i >= 0; i--) Lambda[i] = gfs_mul(ex, lg, n, Lambda[i], gamma);
+    for (i = deg_Omega ; i >= 0; i--)  Omega[i] = gfs_mul(ex, lg, n,  Omega[i], gamma);
+
+    // L(x) = 1 + L1 x + L2 x^2 , L1 = S1 , L2 = (S3 + S1^3)/S1
+    L1 = S[0];
+    L2 = gfs_mul(ex, lg, n, gfs_mul(ex, lg, n, S[0], S[0]), S[0]) ^ S[2];
+    L2 = gfs_mul(ex, lg, n, L2, gfs_inv(ex, lg, n, S[0]));
+    if (S[1] != gfs_mul(ex, lg, n, S[0], S[0]) || S[3] != gfs_mul(ex, lg, n, S[1], S[1])) return -2;
+    if (L1 != Lambda[1] || L2 != Lambda[2]) return -2;
+
+    nerr = 0;
+    for (i = 1; i <= n; i++) { // Lambda(0)=1
+        x = (ui8_t)i;
+        if (polys_eval(ex, lg, n, Lambda, deg_Lambda, x) == 0) {
+            err_pos[nerr] = lg[gfs_inv(ex, lg, n, x)];
+            err_val[nerr] = 1;
+            nerr++;
+        }
+        if (nerr >= deg_Lambda) break;
+    }
+
+    if (nerr < deg_Lambda) return -1; // uncorrectable errors
+    for (i = 0; i < nerr; i++) cw[err_pos[i]] ^= err_val[i];
+
+    return nerr;
+}
+
+INCSTAT
+int rs_decode_RS255(RS_t *RS, ui8_t cw[], ui8_t *err_pos, ui8_t *err_val) {
+    return rs_dec_spec(RS, cw, err_pos, err_val, exp_11D, log_11D, 255, 24, 0, 1, 1);
+}
+
+INCSTAT
+int rs_decode_RS255ccsds(RS_t *RS, ui8_t cw[], ui8_t *err_pos, ui8_t *err_val) {
+    return rs_dec_spec(RS, cw, err_pos, err_val, exp_187, log_187, 255, 32, 112, 11, 116);
+}
+
+INCSTAT
+int rs_decode_BCH64(RS_t *RS, ui8_t cw[], ui8_t *err_pos, ui8_t *err_val) {
+    return bch_dec_spec(RS, cw, err_pos, err_val);
+}
+
 // Errors <= t
 INCSTAT
 int rs_decode(RS_t *RS, ui8_t cw[], ui8_t *err_pos, ui8_t *err_val) {
     ui8_t tmp[1] = {0};
+    GF_t *gf = &RS->GF;
+
+    if (gf->f == 0x11D && RS->N == 255 && RS->R == 24 && RS->b == 0 && RS->p == 1) {
+        return rs_decode_RS255(RS, cw, err_pos, err_val);
+    }
+    if (gf->f == 0x187 && RS->N == 255 && RS->R == 32 && RS->b == 112 && RS->p == 11) {
+        return rs_decode_RS255ccsds(RS, cw, err_pos, err_val);
+    }
     return rs_decode_ErrEra(RS, cw, 0, tmp, err_pos, err_val);
 }
 
+// 0: cw Codewort (alle Syndrome 0)
+INCSTAT
+int rs_check(RS_t *RS, ui8_t cw[]) {
+    ui8_t r[MAX_DEG+1];
+    return rs_rem(RS, cw, r);
+}
+
+// n Codeworte, errors[k] wie rs_decode(cw[k]),
+// err_pos/err_val: 2t pro Codewort (k*2t)
+// erst Test aller cw, dann nur fehlerhafte decodieren
+// return: Anzahl nicht korrigierbarer cw
+INCSTAT
+int rs_decode_batch(RS_t *RS, int n, ui8_t *cw[], int *errors, ui8_t *err_pos, ui8_t *err_val) {
+    int i, k, R2 = 2*RS->t;
+    int nfail = 0;
+
+    for (k = 0; k < n; k++) {
+        errors[k] = rs_check(RS, cw[k]);
+    }
+    for (k = 0; k < n; k++) {
+        if (errors[k]) {
+            errors[k] = rs_decode(RS, cw[k], err_pos+k*R2, err_val+k*R2);
+            if (errors[k] < 0) nfail++;
+        }
+        else {
+            for (i = 0; i < R2; i++) { err_pos[k*R2+i] = 0; err_val[k*R2+i] = 0; }
+        }
+    }
+    return nfail;
+}
+
 INCSTAT
 int rs_decode_bch_gf2t2(RS_t *RS, ui8_t cw[], ui8_t *err_pos, ui8_t *err_val) {
 // binary 2-error correcting BCH
@@ -944,6 +1293,9 @@ int rs_decode_bch_gf2t2(RS_t *RS, ui8_t cw[], ui8_t *err_pos, ui8_t *err_val) {
           Omega[MAX_DEG+1];
     int i, n, errors = 0;
 
+    if (gf->f == 0x43 && RS->N == 63 && RS->R == 12 && RS->t == 2 && RS->b == 1) {
+        return rs_decode_BCH64(RS, cw, err_pos, err_val);
+    }
 
     for (i = 0; i < RS->t; i++) { err_pos[i] = 0; }
     for (i = 0; i < RS->t; i++) { err_val[i] = 0; }
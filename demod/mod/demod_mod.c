@@ -17,51 +17,104 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
 #include "demod_mod.h"
 
 #define FM_GAIN (0.8)
 
+#define F32BLK 4096 // block front end: input samples/block
+#define MAPREL (1<<25) // mmap input: release consumed pages in 32MB steps
+#define MAPCHK (1<<20) // mmap input: file size check in 1MB steps
+#define SHM_POLL 2000  // us, shm input: wait for writer
+
+#define REPLAY_PRE  60.0 // sec, replay segment warm-up (filters, IQ-dc, decoder state e.g. rs41 calib)
+#define REPLAY_POST  4.0 // sec, last frame of segment
+#define REPLAY_OVL  0.25 // sec, segment boundary overlap (header position jitter)
+#define REPLAY_DUP  16   // symbols, same header position in adjacent segments
+#define REPLAY_MAXJOBS 64
+
 /* ------------------------------------------------------------------------------------ */
 
 
 #ifndef EXT_FSK
 
-static void raw_dft(dft_t *dft, float complex *Z) {
-    int s, l, l2, i, j, k;
-    float complex  w1, w2, T;
+// bit-reversal permutation: table for N, N/2 via brv[i]>>1 (i < N/2)
+static void dft_bitrev(dft_t *dft, float complex *Z, int sh) {
+    int i, j;
+    int N = dft->N >> sh;
+    float complex T;
 
-    j = 1;
-    for (i = 1; i < dft->N; i++) {
+    for (i = 1; i < N; i++) {
+        j = dft->brv[i] >> sh;
         if (i < j) {
-            T = Z[j-1];
-            Z[j-1] = Z[i-1];
-            Z[i-1] = T;
+            T = Z[j];
+            Z[j] = Z[i];
+            Z[i] = T;
         }
-        k = dft->N/2;
-        while (k < j) {
-            j = j - k;
-            k = k/2;
+    }
+}
+
+// radix-2^2 butterflies, twiddle tables tw[l2-1+j] = exp(-I*pi*j/l2)
+static void dft_stages(dft_t *dft, float complex *Z, int log2n) {
+    int s, i, j, l2, l4;
+    int a, b, c, d;
+    int N = 1 << log2n;
+    float complex  w1, w2, T, A, B, C, D;
+    float complex *tw1, *tw2;
+
+    s = 0;
+    if (log2n & 1) { // radix-2 stage, w=1
+        for (i = 0; i < N; i += 2) {
+            T = Z[i+1];
+            Z[i+1] = Z[i] - T;
+            Z[i]   = Z[i] + T;
         }
-        j = j + k;
+        s = 1;
     }
 
-    for (s = 0; s < dft->LOG2N; s++) {
+    for ( ; s < log2n; s += 2) {
         l2 = 1 << s;
-        l  = l2 << 1;
-        w1 = (float complex)1.0;
-        w2 = dft->ew[s]; // cexp(-I*M_PI/(float)l2)
-        for (j = 1; j <= l2; j++) {
-            for (i = j; i <= dft->N; i += l) {
-                k = i + l2;
-                T = Z[k-1] * w1;
-                Z[k-1] = Z[i-1] - T;
-                Z[i-1] = Z[i-1] + T;
+        l4 = l2 << 2;
+        tw1 = dft->tw + l2-1;   // stage s
+        tw2 = dft->tw + 2*l2-1; // stage s+1
+        for (i = 0; i < N; i += l4) {
+            for (j = 0; j < l2; j++) {
+                a = i + j;
+                b = a + l2;
+                c = b + l2;
+                d = c + l2;
+                w1 = tw1[j];
+                w2 = tw2[j];
+                T = Z[b] * w1;
+                A = Z[a] + T;
+                B = Z[a] - T;
+                T = Z[d] * w1;
+                C = Z[c] + T;
+                D = Z[c] - T;
+                T = C * w2;
+                Z[a] = A + T;
+                Z[c] = A - T;
+                T = D * w2;
+                T = cimag(T) - I*creal(T); // *(-I)
+                Z[b] = B + T;
+                Z[d] = B - T;
             }
-            w1 = w1 * w2;
         }
     }
 }
 
+static void raw_dft(dft_t *dft, float complex *Z) {
+    dft_bitrev(dft, Z, 0);
+    dft_stages(dft, Z, dft->LOG2N);
+}
+
 static void cdft(dft_t *dft, float complex *z, float complex *Z) {
     int i;
     for (i = 0; i < dft->N; i++)  Z[i] = z[i];
@@ -69,17 +122,69 @@ static void cdft(dft_t *dft, float complex *z, float complex *Z) {
 }
 
 static void rdft(dft_t *dft, float *x, float complex *Z) {
-    int i;
-    for (i = 0; i < dft->N; i++)  Z[i] = (float complex)x[i];
-    raw_dft(dft, Z);
+// real input: N/2-point complex DFT of z[n]=x[2n]+I*x[2n+1], then split
+    int k;
+    int N  = dft->N;
+    int N2 = dft->N/2;
+    float complex *W = dft->tw + N2-1; // exp(-2*pi*I*k/N)
+    float complex Zk, Zm, E, O;
+
+    for (k = 0; k < N2; k++)  Z[k] = x[2*k] + I*x[2*k+1];
+    dft_bitrev(dft, Z, 1);
+    dft_stages(dft, Z, dft->LOG2N-1);
+
+    Zk = Z[0];
+    Z[0]  = creal(Zk) + cimag(Zk);
+    Z[N2] = creal(Zk) - cimag(Zk);
+    for (k = 1; k <= N2/2; k++) {
+        Zk = Z[k];
+        Zm = Z[N2-k];
+        E = 0.5f*(Zk + conj(Zm));
+        O = 0.5f*(Zk - conj(Zm));
+        O = W[k] * (cimag(O) - I*creal(O)); // W^k * O/I
+        Z[k]    = E + O;
+        Z[N-k]  = conj(E + O);
+        Z[N2-k] = conj(E - O);
+        Z[N2+k] = E - O;
+    }
 }
 
-static void Nidft(dft_t *dft, float complex *Z, float complex *z) {
-    int i;
-    for (i = 0; i < dft->N; i++)  z[i] = conj(Z[i]);
-    raw_dft(dft, z);
-    // idft():
-    // for (i = 0; i < dft->N; i++)  z[i] = conj(z[i])/(float)dft->N; // hier: z reell
+static void rNidft(dft_t *dft, float complex *Z, float complex *z) {
+// N*idft(Z) for Z[N-k]=conj(Z[k]), i.e. z reell: N/2-point complex DFT
+    int k;
+    int N2 = dft->N/2;
+    float complex *W = dft->tw + N2-1; // exp(-2*pi*I*k/N)
+    float complex E, O;
+
+    for (k = 0; k < N2; k++) {
+        E = Z[k] + Z[k+N2];
+        O = (Z[k] - Z[k+N2]) * conj(W[k]);
+        z[k] = conj(E + I*O);
+    }
+    dft_bitrev(dft, z, 1);
+    dft_stages(dft, z, dft->LOG2N-1);
+
+    for (k = N2-1; k >= 0; k--) {
+        E = z[k];
+        z[2*k+1] = -cimag(E); // conj
+        z[2*k]   =  creal(E);
+    }
+}
+
+static int dft_tables(dft_t *dft) {
+    int i, j, k, l2;
+
+    for (i = 0; i < dft->N; i++) {
+        j = 0;
+        for (k = 0; k < dft->LOG2N; k++) j |= ((i >> k) & 1) << (dft->LOG2N-1-k);
+        dft->brv[i] = j;
+    }
+
+    for (l2 = 1; l2 < dft->N; l2 <<= 1) {
+        for (j = 0; j < l2; j++) dft->tw[l2-1+j] = cexp(-I*M_PI*j/(double)l2);
+    }
+
+    return 0;
 }
 
 static float bin2freq0(dft_t *dft, int k) {
@@ -152,6 +257,7 @@ static int getCorrDFT(dsp_t *dsp, float thres) {
     float mx2 = 0.0;
     float re_cx = 0.0;
     float xnorm = 1;
+    float xmean = 0.0; // opt_dc: X[0]=0
     ui32_t mpos = 0;
     ui32_t pos = dsp->sample_out;
 
@@ -182,14 +288,15 @@ static int getCorrDFT(dsp_t *dsp, float thres) {
         dc /= 2.0*(float)dsp->L;
         dsp->DFT.X[0] -= dsp->DFT.N * dc  ;//* 0.95;
         */
+        // X[0]=0: xn[i] - mean, mean = X[0]/N (i < N);
+        // no IDFT/DFT round trip, mean only needed for xnorm
+        xmean = creal(dsp->DFT.X[0])/(float)dsp->DFT.N;
         dsp->DFT.X[0] = 0;
-        Nidft(&dsp->DFT, dsp->DFT.X, dsp->DFT.cx);
-        for (i = 0; i < dsp->DFT.N; i++) dsp->DFT.xn[i] = creal(dsp->DFT.cx[i])/(float)dsp->DFT.N;
     }
 
     for (i = 0; i < dsp->DFT.N; i++) dsp->DFT.Z[i] = dsp->DFT.X[i]*dsp->DFT.Fm[i];
 
-    Nidft(&dsp->DFT, dsp->DFT.Z, dsp->DFT.cx);
+    rNidft(&dsp->DFT, dsp->DFT.Z, dsp->DFT.cx);
 
 
     // relativ Peak - Normierung erst zum Schluss;
@@ -213,7 +320,7 @@ static int getCorrDFT(dsp_t *dsp, float thres) {
 
     //xnorm = sqrt(dsp->qs[(mpos + 2*dsp->M) % dsp->M]); // Nvar = L
     xnorm = 0.0;
-    for (i = 0; i < dsp->L; i++) xnorm += dsp->DFT.xn[mp-i]*dsp->DFT.xn[mp-i];
+    for (i = 0; i < dsp->L; i++) xnorm += (dsp->DFT.xn[mp-i]-xmean)*(dsp->DFT.xn[mp-i]-xmean);
     xnorm = sqrt(xnorm);
 
     mx /= xnorm*dsp->DFT.N;
@@ -235,13 +342,12 @@ static int getCorrDFT(dsp_t *dsp, float thres) {
             while (i < dsp->DFT.N) dsp->DFT.xn[i++] = 0.0;
             rdft(&dsp->DFT, dsp->DFT.xn, dsp->DFT.X);
 
+            xmean = creal(dsp->DFT.X[0])/(float)dsp->DFT.N;
             dsp->DFT.X[0] = 0;
-            Nidft(&dsp->DFT, dsp->DFT.X, dsp->DFT.cx);
-            for (i = 0; i < dsp->DFT.N; i++) dsp->DFT.xn[i] = creal(dsp->DFT.cx[i])/(float)dsp->DFT.N;
 
             for (i = 0; i < dsp->DFT.N; i++) dsp->DFT.Z[i] = dsp->DFT.X[i]*dsp->DFT.Fm[i];
 
-            Nidft(&dsp->DFT, dsp->DFT.Z, dsp->DFT.cx);
+            rNidft(&dsp->DFT, dsp->DFT.Z, dsp->DFT.cx);
 
             mx2 = 0.0;                                      // t = L-1
             for (i = dsp->L-1; i < dsp->K + dsp->L; i++) {  // i=t .. i=t+K < t+1+K
@@ -258,7 +364,7 @@ static int getCorrDFT(dsp_t *dsp, float thres) {
             mpos = pos - (dsp->K + dsp->L-1) + mp; // t = L-1
 
             xnorm = 0.0;
-            for (i = 0; i < dsp->L; i++) xnorm += dsp->DFT.xn[mp-i]*dsp->DFT.xn[mp-i];
+            for (i = 0; i < dsp->L; i++) xnorm += (dsp->DFT.xn[mp-i]-xmean)*(dsp->DFT.xn[mp-i]-xmean);
             xnorm = sqrt(xnorm);
 
             mx /= xnorm*dsp->DFT.N;
@@ -376,6 +482,214 @@ int read_wav_header(pcm_t *pcm, FILE *fp) {
 }
 
 
+/* ------------------------------------------------------------------------------------ */
+/*
+ *  input: regular files (wav, raw IQ) memory-mapped, else (pipe, stdin) stdio;
+ *  dsp_fread(): fread() replacement,
+ *  dsp_fblock(): zero-copy, pointer into the mapping (stdio: fread into blk_raw)
+ *  The mapping has the file size at start. File still being written: at the end
+ *  of the mapping continue with stdio. File truncated: EOF at the new size,
+ *  checked every MAPCHK bytes (truncated within the last MAPCHK bytes read: SIGBUS).
+ */
+
+static int dsp_mmap(dsp_t *dsp) {
+    struct stat st;
+    long ofs;
+    void *map;
+
+    dsp->map = NULL;
+    if (dsp->fp == NULL || dsp->shm) return -1;
+    if (fstat(fileno(dsp->fp), &st) != 0 || !S_ISREG(st.st_mode)) return -1;
+    ofs = ftell(dsp->fp);  // data chunk, after read_wav_header()
+    if (ofs < 0 || ofs % 4 || (off_t)ofs >= st.st_size) return -1;
+    if ((off_t)(size_t)st.st_size != st.st_size) return -1;
+
+    map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fileno(dsp->fp), 0);
+    if (map == MAP_FAILED) return -1;
+    madvise(map, st.st_size, MADV_SEQUENTIAL);
+
+    dsp->map = map;
+    dsp->map_len = st.st_size;
+    dsp->map_pos = ofs;
+    dsp->map_rel = 0;
+    dsp->map_end = dsp->map_len;
+    dsp->map_chk = ofs + MAPCHK;
+    if (dsp->seg_lim > 0 && dsp->seg_lim < dsp->map_end) dsp->map_end = dsp->seg_lim;
+    return 0;
+}
+
+static void dsp_munmap(dsp_t *dsp) {
+    if (dsp->map) {
+        munmap(dsp->map, dsp->map_len);
+        fseek(dsp->fp, dsp->map_pos, SEEK_SET);
+        dsp->map = NULL;
+    }
+}
+
+// file size changed since dsp_mmap(): shorter -> map_end,
+// longer and end of mapping reached -> stdio (not in replay segment)
+static void dsp_mapchk(dsp_t *dsp, size_t len) {
+    struct stat st;
+
+    dsp->map_chk = dsp->map_pos + MAPCHK;
+    if (fstat(fileno(dsp->fp), &st) != 0) return;
+    if ((size_t)st.st_size < dsp->map_end) {
+        dsp->map_end = ((size_t)st.st_size > dsp->map_pos) ? (size_t)st.st_size : dsp->map_pos;
+    }
+    else if ((size_t)st.st_size > dsp->map_len && dsp->map_pos + len > dsp->map_end && dsp->seg_lim == 0) {
+        dsp_munmap(dsp);
+    }
+}
+
+/*
+ *  input: shared memory ring (--shm <name>, writer iq_shm), live stream.
+ *  The ring is mapped twice back to back, so each block is contiguous (zero-copy).
+ *  rd_pos: block in use; the writer throttles only if started with --readers,
+ *  else a reader more than one ring behind has lost data (overrun)
+ *  and continues half a ring behind the writer.
+ */
+
+static void *shm_map2(int fd, size_t len, int prot) {
+    ui8_t *p = mmap(NULL, 2*len, PROT_NONE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) return NULL;
+    if (mmap(p,     len, prot, MAP_SHARED|MAP_FIXED, fd, SHM_HDRLEN) == MAP_FAILED ||
+        mmap(p+len, len, prot, MAP_SHARED|MAP_FIXED, fd, SHM_HDRLEN) == MAP_FAILED) {
+        munmap(p, 2*len);
+        return NULL;
+    }
+    return p;
+}
+
+int shm_attach(dsp_t *dsp, pcm_t *pcm, char *name) {
+    char path[256];
+    shm_hdr_t *h;
+    int fd, k;
+    ui32_t pid0;
+
+    snprintf(path, sizeof(path), "%s%s", name[0] == '/' ? "" : "/", name);
+    fd = shm_open(path, O_RDWR, 0);
+    if (fd < 0) return -1;
+    h = mmap(NULL, SHM_HDRLEN, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+    if (h == MAP_FAILED) { close(fd); return -1; }
+    if (h->magic != SHM_MAGIC || h->nch != 2 || (h->bps != 8 && h->bps != 16 && h->bps != 32)) {
+        munmap(h, SHM_HDRLEN); close(fd);
+        return -1;
+    }
+    dsp->shm_buf = shm_map2(fd, h->size, PROT_READ);
+    close(fd);
+    if (dsp->shm_buf == NULL) { munmap(h, SHM_HDRLEN); return -1; }
+
+    for (k = 0; k < SHM_MAXRD; k++) {
+        pid0 = 0;
+        if (__atomic_compare_exchange_n(&h->rd_pid[k], &pid0, (ui32_t)getpid(), 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) break;
+    }
+    if (k == SHM_MAXRD) {
+        fprintf(stderr, "shm: %d readers\n", SHM_MAXRD);
+        munmap(dsp->shm_buf, 2*h->size); munmap(h, SHM_HDRLEN);
+        return -1;
+    }
+    // live: start at the writer position
+    dsp->shm_pos = __atomic_load_n(&h->wpos, __ATOMIC_ACQUIRE);
+    __atomic_store_n(&h->rd_pos[k], dsp->shm_pos, __ATOMIC_RELEASE);
+    dsp->shm_len = 0;
+    dsp->shm_lost = 0;
+    dsp->shm_rd = k;
+    dsp->shm = h;
+
+    pcm->sr  = h->sr;
+    pcm->bps = h->bps;
+    pcm->nch = h->nch;
+    fprintf(stderr, "shm: %s  ring: %.1f sec\n", path, h->size/(double)(h->sr*h->nch*(h->bps/8)));
+
+    return 0;
+}
+
+static void shm_detach(dsp_t *dsp) {
+    shm_hdr_t *h = dsp->shm;
+    if (h) {
+        if (dsp->shm_lost) {
+            fprintf(stderr, "shm: overrun, %.2f sec lost\n", dsp->shm_lost/(double)(h->sr*h->nch*(h->bps/8)));
+        }
+        __atomic_store_n(&h->rd_pid[dsp->shm_rd], 0, __ATOMIC_RELEASE);
+        munmap(dsp->shm_buf, 2*h->size);
+        munmap(h, SHM_HDRLEN);
+        dsp->shm = NULL;
+    }
+}
+
+static void *shm_block(dsp_t *dsp, size_t size, size_t nmemb, size_t *n) {
+    shm_hdr_t *h = dsp->shm;
+    ui64_t frm = h->nch*(h->bps/8);
+    ui64_t need = size*nmemb;
+    ui64_t prev = dsp->shm_pos;  // block in use
+    ui64_t w, lost;
+
+    if (need > h->size/4) need = h->size/4 / size * size;
+
+    dsp->shm_pos += dsp->shm_len;
+    dsp->shm_len = 0;
+
+    for (;;) {
+        w = __atomic_load_n(&h->wpos, __ATOMIC_ACQUIRE);
+        // overrun: block in use overwritten
+        if (w - prev > h->size) {
+            lost = w - h->size/2 - dsp->shm_pos;
+            lost -= lost % frm;
+            dsp->shm_pos += lost;
+            dsp->shm_lost += lost;
+            fprintf(stderr, "shm: overrun (%.3f sec)\n", lost/(double)(h->sr*frm));
+        }
+        prev = dsp->shm_pos;
+        __atomic_store_n(&h->rd_pos[dsp->shm_rd], dsp->shm_pos, __ATOMIC_RELEASE);
+        if (w - dsp->shm_pos >= need) break;
+        if (__atomic_load_n(&h->eof, __ATOMIC_ACQUIRE) || (kill(h->wr_pid, 0) != 0 && errno == ESRCH)) {
+            w = __atomic_load_n(&h->wpos, __ATOMIC_ACQUIRE);
+            need = (w - dsp->shm_pos) / size * size;
+            break;
+        }
+        usleep(SHM_POLL);
+    }
+    dsp->shm_len = need;
+    *n = need / size;
+    return dsp->shm_buf + dsp->shm_pos % h->size;
+}
+
+static void *dsp_fblock(dsp_t *dsp, size_t size, size_t nmemb, size_t *n) {
+    void *p;
+    if (dsp->shm) return shm_block(dsp, size, nmemb, n);
+    if (dsp->map && (dsp->map_pos >= dsp->map_chk || dsp->map_pos + size*nmemb > dsp->map_end)) dsp_mapchk(dsp, size*nmemb);
+    if (dsp->map == NULL) {
+        *n = fread(dsp->blk_raw, size, nmemb, dsp->fp);
+        return dsp->blk_raw;
+    }
+    // consumed pages not needed again
+    while (dsp->map_rel + MAPREL <= dsp->map_pos) {
+        madvise(dsp->map + dsp->map_rel, MAPREL, MADV_DONTNEED);
+        dsp->map_rel += MAPREL;
+    }
+    p = dsp->map + dsp->map_pos;
+    *n = (dsp->map_end - dsp->map_pos) / size;
+    if (*n > nmemb) *n = nmemb;
+    dsp->map_pos += *n * size;
+    return p;
+}
+
+static size_t dsp_fread(void *ptr, size_t size, size_t nmemb, dsp_t *dsp) {
+    size_t n;
+    if (dsp->shm) {
+        void *p = shm_block(dsp, size, nmemb, &n);
+        memcpy(ptr, p, n * size);
+        return n;
+    }
+    if (dsp->map && (dsp->map_pos >= dsp->map_chk || dsp->map_pos + size*nmemb > dsp->map_end)) dsp_mapchk(dsp, size*nmemb);
+    if (dsp->map == NULL) return fread(ptr, size, nmemb, dsp->fp);
+    n = (dsp->map_end - dsp->map_pos) / size;
+    if (n > nmemb) n = nmemb;
+    memcpy(ptr, dsp->map + dsp->map_pos, n * size);
+    dsp->map_pos += n * size;
+    return n;
+}
+
 static int f32read_sample(dsp_t *dsp, float *s) {
     int i;
     unsigned int word = 0;
@@ -384,7 +698,7 @@ static int f32read_sample(dsp_t *dsp, float *s) {
 
     for (i = 0; i < dsp->nch; i++) {
 
-        if (fread( &word, dsp->bps/8, 1, dsp->fp) != 1) return EOF;
+        if (dsp_fread( &word, dsp->bps/8, 1, dsp) != 1) return EOF;
 
         if (i == dsp->ch) {  // i = 0: links bzw. mono
             //if (bits_sample ==  8)  sint = b-128;   // 8bit: 00..FF, centerpoint 0x80=128
@@ -422,19 +736,19 @@ static int f32read_csample(dsp_t *dsp, float complex *z) {
 
     if (dsp->bps == 32) { //float32
         float f[2];
-        if (fread( f, dsp->bps/8, 2, dsp->fp) != 2) return EOF;
+        if (dsp_fread( f, dsp->bps/8, 2, dsp) != 2) return EOF;
         x = f[0];
         y = f[1];
     }
     else if (dsp->bps == 16) { //int16
         short b[2];
-        if (fread( b, dsp->bps/8, 2, dsp->fp) != 2) return EOF;
+        if (dsp_fread( b, dsp->bps/8, 2, dsp) != 2) return EOF;
         x = b[0]/32768.0;
         y = b[1]/32768.0;
     }
     else {  // dsp->bps == 8   //uint8
         ui8_t u[2];
-        if (fread( u, dsp->bps/8, 2, dsp->fp) != 2) return EOF;
+        if (dsp_fread( u, dsp->bps/8, 2, dsp) != 2) return EOF;
         x = (u[0]-128)/128.0;
         y = (u[1]-128)/128.0;
     }
@@ -460,41 +774,43 @@ static int f32read_csample(dsp_t *dsp, float complex *z) {
     return 0;
 }
 
-static int f32read_cblock(dsp_t *dsp) {
+static void f32conv_cblock(dsp_t *dsp, void *raw, float complex *zb, int len, int iqdc) {
 
-    int n;
-    int len;
-    float x, y;
-    ui8_t s[4*2*dsp->decM]; //uin8,int16,flot32
-    ui8_t *u = (ui8_t*)s;
-    short *b = (short*)s;
-    float *f = (float*)s;
-
-
-    len = fread( s, dsp->bps/8, 2*dsp->decM, dsp->fp) / 2;
+    int n, m;
+    const ui8_t *u = (const ui8_t*)raw;
+    const short *b = (const short*)raw;
 
-    //for (n = 0; n < len; n++) dsp->decMbuf[n] = (u[2*n]-128)/128.0 + I*(u[2*n+1]-128)/128.0;
     // u8: 0..255, 128 -> 0V
-    for (n = 0; n < len; n++) {
-        if (dsp->bps == 8) { //uint8
-            x = (u[2*n  ]-128)/128.0;
-            y = (u[2*n+1]-128)/128.0;
-        }
-        else if (dsp->bps == 16) { //int16
-            x = b[2*n  ]/32768.0;
-            y = b[2*n+1]/32768.0;
-        }
-        else { // dsp->bps == 32   //float32
-            x = f[2*n];
-            y = f[2*n+1];
+    // (scale 2^-7, 2^-15: same as division)
+    if (dsp->bps == 8) { //uint8
+        for (n = 0; n < len; n++) zb[n] = (u[2*n]-128)*(1.0f/128.0f) + I*((u[2*n+1]-128)*(1.0f/128.0f));
+    }
+    else if (dsp->bps == 16) { //int16
+        for (n = 0; n < len; n++) zb[n] = b[2*n]*(1.0f/32768.0f) + I*(b[2*n+1]*(1.0f/32768.0f));
+    }
+    else { // dsp->bps == 32   //float32, re,im interleaved like zb
+        memcpy(zb, raw, len*sizeof(float complex));
+    }
+
+    if (iqdc == 0) return;
+
+    // IQ-dc removal: runs up to next avg update
+    n = 0;
+    while (n < len) {
+        float complex avg = IQdc.avgIQx + I*IQdc.avgIQy;
+        double sx = 0.0, sy = 0.0;
+        int k;
+        m = len - n;
+        if (m > IQdc.maxcnt - IQdc.cnt) m = IQdc.maxcnt - IQdc.cnt;
+        for (k = n; k < n+m; k++) {
+            sx += crealf(zb[k]);
+            sy += cimagf(zb[k]);
+            zb[k] -= avg;
         }
-
-        // baseband: IQ-dc removal mandatory
-        dsp->decMbuf[n] = (x-IQdc.avgIQx) + I*(y-IQdc.avgIQy);
-
-        IQdc.sumIQx += x;
-        IQdc.sumIQy += y;
-        IQdc.cnt += 1;
+        IQdc.sumIQx += sx;
+        IQdc.sumIQy += sy;
+        IQdc.cnt += m;
+        n += m;
         if (IQdc.cnt == IQdc.maxcnt) {
             IQdc.avgIQx = IQdc.sumIQx/(float)IQdc.maxcnt;
             IQdc.avgIQy = IQdc.sumIQy/(float)IQdc.maxcnt;
@@ -503,6 +819,17 @@ static int f32read_cblock(dsp_t *dsp) {
             if (IQdc.maxcnt < IQdc.maxlim) IQdc.maxcnt *= 2;
         }
     }
+}
+
+static int f32read_cblock(dsp_t *dsp) {
+
+    int len;
+    ui8_t s[4*2*dsp->decM]; //uin8,int16,flot32
+
+    len = dsp_fread( s, dsp->bps/8, 2*dsp->decM, dsp) / 2;
+
+    // baseband: IQ-dc removal mandatory
+    f32conv_cblock(dsp, s, dsp->decMbuf, len, 1);
 
     return len;
 }
@@ -586,6 +913,132 @@ static int lowpass_init(float f, int taps, float **pws) {
     return taps;
 }
 
+/* ------------------------------------------------------------------------------------ */
+/*
+ *  table cache: RS_TABCACHE=<dir>
+ *  init_buffers() tables (header match/spectrum, FFT window/twiddles, lowpass taps,
+ *  mixer LUT) stored per key (input parameters), restart with same key reads them back
+ */
+
+#define TABCACHE_ID "dsptab01"
+
+typedef struct {
+    char id[8];
+    int sr;
+    int opt_iq;
+    int opt_IFmin;
+    int opt_lp;
+    int opt_nolut;
+    int lpIQ_bw;
+    int lpFM_bw;
+    int hdrlen;
+    float sps;
+    float BT;
+    double xlt_fq;
+} tabkey_t;
+
+typedef struct {
+    FILE *fp;
+    int rd;  // 1: read tables, 0: write tables
+    int err; // 1: error, discard new cache file
+    char path[512];
+    char tmp[544];
+} tabcache_t;
+
+static void tab_open(tabcache_t *tc, dsp_t *dsp) {
+    tabkey_t key, key1;
+    char *dir = getenv("RS_TABCACHE");
+    ui32_t h = 2166136261u; // FNV-1a
+    ui8_t *b = (ui8_t*)&key;
+    int i;
+
+    memset(tc, 0, sizeof(*tc));
+    if (dir == NULL || *dir == '\0') return;
+
+    memset(&key, 0, sizeof(key));
+    memcpy(key.id, TABCACHE_ID, 8);
+    key.sr = dsp->sr;
+    key.opt_iq = dsp->opt_iq;
+    key.opt_IFmin = dsp->opt_IFmin;
+    key.opt_lp = dsp->opt_lp;
+    key.opt_nolut = dsp->opt_nolut;
+    key.lpIQ_bw = dsp->lpIQ_bw;
+    key.lpFM_bw = dsp->lpFM_bw;
+    key.hdrlen = dsp->hdrlen;
+    key.sps = dsp->sps;
+    key.BT = dsp->BT;
+    key.xlt_fq = dsp->xlt_fq;
+
+    for (i = 0; i < sizeof(key); i++) { h ^= b[i]; h *= 16777619u; }
+    for (i = 0; i < dsp->hdrlen; i++) { h ^= (ui8_t)dsp->hdr[i]; h *= 16777619u; }
+    snprintf(tc->path, sizeof(tc->path), "%s/dsp_%08x.tab", dir, h);
+
+    tc->fp = fopen(tc->path, "rb");
+    if (tc->fp) {
+        tc->rd = 1;
+        if (fread(&key1, sizeof(key1), 1, tc->fp) != 1 || memcmp(&key, &key1, sizeof(key)) != 0) tc->rd = 0;
+        for (i = 0; i < dsp->hdrlen && tc->rd; i++) {
+            if (fgetc(tc->fp) != (ui8_t)dsp->hdr[i]) tc->rd = 0;
+        }
+        if (tc->rd) return;
+        fclose(tc->fp);
+    }
+
+    // new cache file: tmp, rename when complete
+    snprintf(tc->tmp, sizeof(tc->tmp), "%s.%d", tc->path, (int)getpid());
+    tc->rd = 0;
+    tc->fp = fopen(tc->tmp, "wb");
+    if (tc->fp == NULL) return;
+    if (fwrite(&key, sizeof(key), 1, tc->fp) != 1 || fwrite(dsp->hdr, 1, dsp->hdrlen, tc->fp) != dsp->hdrlen) {
+        fclose(tc->fp); tc->fp = NULL;
+        remove(tc->tmp);
+    }
+}
+
+// 0: table read from cache, else compute (and tab_put)
+static int tab_get(tabcache_t *tc, void *p, size_t size) {
+    if (tc->fp == NULL || !tc->rd) return -1;
+    if (fread(p, size, 1, tc->fp) != 1) {
+        fclose(tc->fp); tc->fp = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+static void tab_put(tabcache_t *tc, void *p, size_t size) {
+    if (tc->fp == NULL || tc->rd) return;
+    if (fwrite(p, size, 1, tc->fp) != 1) {
+        fclose(tc->fp); tc->fp = NULL;
+        remove(tc->tmp);
+    }
+}
+
+static void tab_close(tabcache_t *tc) {
+    if (tc->fp == NULL) return;
+    if (tc->rd) fclose(tc->fp);
+    else if (fclose(tc->fp) != 0 || tc->err || rename(tc->tmp, tc->path) != 0) remove(tc->tmp);
+    tc->fp = NULL;
+}
+
+static int lowpass_tab(tabcache_t *tc, float f, int taps, float **pws) {
+    float *ws = NULL;
+
+    if (taps % 2 == 0) taps++;
+    if ( taps < 1 ) taps = 1;
+
+    ws = (float*)calloc( 2*taps+1, sizeof(float)); if (ws == NULL) return -1;
+    if (tab_get(tc, ws, 2*taps*sizeof(float)) == 0) {
+        *pws = ws;
+        return taps;
+    }
+    free(ws);
+
+    taps = lowpass_init(f, taps, pws); if (taps < 0) return -1;
+    tab_put(tc, *pws, 2*taps*sizeof(float));
+
+    return taps;
+}
+
 
 static int lowpass_update(float f, int taps, float *ws) {
     double *h, *w;
@@ -651,6 +1104,50 @@ static float complex lowpass(float complex buffer[], ui32_t sample, ui32_t taps,
     return w;
 // symmetry: ws[n] == ws[taps-1-n]
 }
+// decimate: linear delay line xre/xim[0..2*taps-1], x[n] == x[n+taps],
+// window x[s+1..s+taps] contiguous (same order as lowpass()), no wrap/modulo;
+// separate re/im arrays -> packed float (SSE/AVX/NEON via -Ofast autovectorization),
+// x86-64: avx2/default clones, selected at load time
+#if defined(__GNUC__) && defined(__x86_64__) && defined(__linux__)
+  #define DEC_VEC __attribute__((target_clones("avx2","default")))
+#else
+  #define DEC_VEC
+#endif
+DEC_VEC
+static float complex lowpass_vec(float *xre, float *xim, ui32_t sample, ui32_t taps, float *ws) {
+    float *restrict xr = xre + sample+1;
+    float *restrict xi = xim + sample+1;
+    float wr = 0, wi = 0;  // -Ofast
+    int n;
+    for (n = 0; n < taps; n++) {
+        wr += xr[n]*ws[n];
+        wi += xi[n]*ws[n];
+    }
+    return wr + I*wi;
+}
+DEC_VEC
+static void mix_decX(dsp_t *dsp, float complex *zM) {
+    ui32_t T = dsp->dectaps;
+    int j = 0;
+    while (j < dsp->decM) {
+        float complex *restrict zb = zM + j;
+        float complex *restrict ex = dsp->ex + dsp->sample_decM;
+        float *restrict xr = dsp->decXre + dsp->sample_decX;
+        float *restrict xi = dsp->decXim + dsp->sample_decX;
+        int run = dsp->decM - j;
+        int n;
+        if (run > dsp->lut_len - dsp->sample_decM) run = dsp->lut_len - dsp->sample_decM;
+        if (run > T - dsp->sample_decX) run = T - dsp->sample_decX;
+        for (n = 0; n < run; n++) {
+            float complex z = zb[n] * ex[n];
+            xr[n] = xr[n+T] = crealf(z);
+            xi[n] = xi[n+T] = cimagf(z);
+        }
+        j += run;
+        dsp->sample_decM += run; if (dsp->sample_decM >= dsp->lut_len) dsp->sample_decM = 0;
+        dsp->sample_decX += run; if (dsp->sample_decX >= T) dsp->sample_decX = 0;
+    }
+}
 static float complex lowpass0_sym(float complex buffer[], ui32_t sample, ui32_t taps, float *ws) {
     ui32_t n;
     double complex w = buffer[(sample+(taps+1)/2) % taps]*ws[(taps-1)/2]; // (N+1)/2 = (N-1)/2 + 1
@@ -708,60 +1205,109 @@ static float re_lowpass(float buffer[], ui32_t sample, ui32_t taps, float *ws) {
 }
 
 
-int f32buf_sample(dsp_t *dsp, int inv) {
-    float s = 0.0;
-    float s_fm = s;
-    float xneu, xalt;
+// NCO instead of cexp() per sample: z *= w, exact phase at f/n change and every NCO_SEED samples;
+// phase f*n of absolute sample n (as cexp(f*n*2pi*I)), i.e. Df update in find_header() unchanged
+#define NCO_SEED 1024
 
-    float complex z, w, z0;
-    double gain = FM_GAIN;
+static void nco_set(nco_t *o, double f, ui32_t n) {
+    double ph = f*(double)n;
+    ph -= floor(ph);
+    o->f = f;
+    o->z = cexp(ph*_2PI*I);
+    o->w = cexp(f*_2PI*I);
+    o->n = n;
+    o->k = 0;
+}
 
-    double t = dsp->sample_in / (double)dsp->sr;
+static double complex nco_exp(nco_t *o, double f, ui32_t n) {
+    double complex z;
+    if (f != o->f || n != o->n || o->k >= NCO_SEED) nco_set(o, f, n);
+    z = o->z;
+    o->z *= o->w;
+    o->n += 1;
+    o->k += 1;
+    return z;
+}
 
-    if (dsp->opt_iq)
-    {
-        if (dsp->opt_iq == 5) {
-            int j;
-            if ( f32read_cblock(dsp) < dsp->decM ) return EOF;
-            for (j = 0; j < dsp->decM; j++) {
-                if (dsp->opt_nolut) {
-                    double _s_base = (double)(dsp->sample_in*dsp->decM+j); // dsp->sample_dec
-                    double f0 = dsp->xlt_fq*_s_base - dsp->Df*_s_base/(double)dsp->sr_base;
-                    z = dsp->decMbuf[j] * cexp(f0*_2PI*I);
-                }
-                else {
-                    z = dsp->decMbuf[j] * dsp->ex[dsp->sample_decM];
-                }
-                dsp->sample_decM += 1; if (dsp->sample_decM >= dsp->lut_len) dsp->sample_decM = 0;
+static float complex decimate(dsp_t *dsp, float complex *zM, ui32_t sample) {
+    float complex z = 0;
+    int j;
 
+    if (dsp->decM > 1 && !dsp->opt_novec && !dsp->opt_nolut) {
+        mix_decX(dsp, zM); // LUT, contiguous runs
+    }
+    else {
+        for (j = 0; j < dsp->decM; j++) {
+            if (dsp->opt_nolut) {
+                ui32_t _s_base = sample*dsp->decM+j; // dsp->sample_dec
+                double f0 = dsp->xlt_fq - dsp->Df/(double)dsp->sr_base;
+                z = zM[j] * nco_exp(&dsp->nco_mix, f0, _s_base);
+            }
+            else {
+                z = zM[j] * dsp->ex[dsp->sample_decM];
+            }
+            dsp->sample_decM += 1; if (dsp->sample_decM >= dsp->lut_len) dsp->sample_decM = 0;
+
+            if (dsp->opt_novec) {
                 dsp->decXbuffer[dsp->sample_decX] = z;
-                dsp->sample_decX += 1; if (dsp->sample_decX >= dsp->dectaps) dsp->sample_decX = 0;
             }
-            if (dsp->decM > 1)
-            {
-                z = lowpass(dsp->decXbuffer, dsp->sample_decX, dsp->dectaps, ws_dec);
+            else {
+                dsp->decXre[dsp->sample_decX] = dsp->decXre[dsp->sample_decX + dsp->dectaps] = crealf(z);
+                dsp->decXim[dsp->sample_decX] = dsp->decXim[dsp->sample_decX + dsp->dectaps] = cimagf(z);
             }
+            dsp->sample_decX += 1; if (dsp->sample_decX >= dsp->dectaps) dsp->sample_decX = 0;
         }
-        else if ( f32read_csample(dsp, &z) == EOF ) return EOF;
+    }
+    if (dsp->decM > 1)
+    {
+        if (dsp->opt_novec) z = lowpass(dsp->decXbuffer, dsp->sample_decX, dsp->dectaps, ws_dec);
+        else                z = lowpass_vec(dsp->decXre, dsp->decXim, dsp->sample_decX, dsp->dectaps, ws_dec);
+    }
 
-        if (dsp->opt_dc && !dsp->opt_nolut)
-        {
-            z *= cexp(-t*_2PI*dsp->Df*I);
-        }
+    return z;
+}
 
+// FM discriminator: atan2() polynomial, |err| < 1e-5 rad (Abramowitz/Stegun 4.4.49),
+// no branches/libm -> vectorized in fm_disc_blk()
+static inline float atan2_poly(float y, float x) {
+    float ax = fabsf(x), ay = fabsf(y);
+    float mx = ax > ay ? ax : ay;
+    float mn = ax > ay ? ay : ax;
+    float a = mx > 0.0f ? mn/mx : 0.0f;
+    float q = a*a;
+    float r = a*(0.9998660f + q*(-0.3302995f + q*(0.1801410f + q*(-0.0851330f + q*0.0208351f))));
+    r = ay > ax ? (float)(M_PI/2.0) - r : r;
+    r = x < 0.0f ? (float)M_PI - r : r;
+    return y < 0.0f ? -r : r;
+}
 
-        // IF-lowpass
-        if (dsp->opt_lp & LP_IQ) {
-            dsp->lpIQ_buf[dsp->sample_in % dsp->lpIQtaps] = z;
-            z = lowpass(dsp->lpIQ_buf, dsp->sample_in, dsp->lpIQtaps, dsp->ws_lpIQ);
-        }
+// s[k] = gain*arg(z[k]*conj(z[k-1]))/pi, z[-1] = z0
+DEC_VEC
+static void fm_disc_blk(float complex *z, float complex z0, float *s, int n) {
+    const float *p = (const float *)z;
+    const float g = FM_GAIN/M_PI;
+    int k;
+
+    if (n <= 0) return;
+    s[0] = g * atan2_poly(cimagf(z[0])*crealf(z0) - crealf(z[0])*cimagf(z0),
+                          crealf(z[0])*crealf(z0) + cimagf(z[0])*cimagf(z0));
+    for (k = 1; k < n; k++) {
+        float ar = p[2*k], ai = p[2*k+1];
+        float br = p[2*k-2], bi = p[2*k-1];
+        s[k] = g * atan2_poly(ai*br - ar*bi, ar*br + ai*bi);
+    }
+}
 
+// IQ: s_fm = discriminator(z) -> s (FM or F1sum/F2sum), FM: s ; FM-lowpass -> s_fm
+static float demod_fm(dsp_t *dsp, ui32_t sample, float complex z, float s, float *ps_fm) {
+    float s_fm = s;
+    float complex z0;
 
-        z0 = dsp->rot_iqbuf[(dsp->sample_in-1 + dsp->N_IQBUF) % dsp->N_IQBUF];
-        w = z * conj(z0);
-        s_fm = gain * carg(w)/M_PI;
+    double t = sample / (double)dsp->sr;
 
-        dsp->rot_iqbuf[dsp->sample_in % dsp->N_IQBUF] = z;  // sample_in & (N-1) , N = (1<<LOG2N)
+    if (dsp->opt_iq)
+    {
+        dsp->rot_iqbuf[sample % dsp->N_IQBUF] = z;  // sample & (N-1) , N = (1<<LOG2N)
 
 
         if (dsp->opt_iq >= 2)
@@ -772,24 +1318,21 @@ int f32buf_sample(dsp_t *dsp, int inv) {
                 //double f1 = -dsp->h*dsp->sr/(2.0*dsp->sps);
                 //double f2 = -f1;
 
-                float complex X0 = 0;
-                float complex X  = 0;
+                double complex e1, e2;
 
                 int n = dsp->sps;
-                double tn = (dsp->sample_in-n) / (double)dsp->sr;
-                //t = dsp->sample_in / (double)dsp->sr;
-                //z = dsp->rot_iqbuf[dsp->sample_in % dsp->N_IQBUF];
-                z0 = dsp->rot_iqbuf[(dsp->sample_in-n + dsp->N_IQBUF) % dsp->N_IQBUF];
+                //t = sample / (double)dsp->sr;
+                //z = dsp->rot_iqbuf[sample % dsp->N_IQBUF];
+                z0 = dsp->rot_iqbuf[(sample-n + dsp->N_IQBUF) % dsp->N_IQBUF];
 
+                // X = z*exp(-t*iw), X0 = z0*exp(-tn*iw) = z0*exp(-t*iw)*dw
                 // f1
-                X0 = z0 * cexp(-tn*dsp->iw1); // alt
-                X  = z  * cexp(-t *dsp->iw1); // neu
-                dsp->F1sum +=  X - X0;
+                e1 = nco_exp(&dsp->nco_f1, dsp->nco_f1.f, sample);
+                dsp->F1sum += e1 * (z - z0*dsp->dw1); // neu - alt
 
                 // f2
-                X0 = z0 * cexp(-tn*dsp->iw2); // alt
-                X  = z  * cexp(-t *dsp->iw2); // neu
-                dsp->F2sum +=  X - X0;
+                e2 = nco_exp(&dsp->nco_f2, dsp->nco_f2.f, sample);
+                dsp->F2sum += e2 * (z - z0*dsp->dw2); // neu - alt
 
                 xbit = cabs(dsp->F2sum) - cabs(dsp->F1sum);
 
@@ -809,7 +1352,7 @@ int f32buf_sample(dsp_t *dsp, int inv) {
                 while (n > 0) {
                     n--;
                     t = -n / (double)dsp->sr;
-                    z = dsp->rot_iqbuf[(dsp->sample_in - n + dsp->N_IQBUF) % dsp->N_IQBUF];  // +1
+                    z = dsp->rot_iqbuf[(sample - n + dsp->N_IQBUF) % dsp->N_IQBUF];  // +1
                     X1 += z*cexp(-t*dsp->iw1);
                     X2 += z*cexp(-t*dsp->iw2);
                 }
@@ -823,18 +1366,161 @@ int f32buf_sample(dsp_t *dsp, int inv) {
             s = s_fm;
         }
     }
-    else {
-        if (f32read_sample(dsp, &s) == EOF) return EOF;
-        s_fm = s;
-    }
 
     // FM-lowpass
     if (dsp->opt_lp & LP_FM) {
-        dsp->lpFM_buf[dsp->sample_in % dsp->lpFMtaps] = s_fm;
-        s_fm = re_lowpass(dsp->lpFM_buf, dsp->sample_in, dsp->lpFMtaps, dsp->ws_lpFM);
+        dsp->lpFM_buf[sample % dsp->lpFMtaps] = s_fm;
+        s_fm = re_lowpass(dsp->lpFM_buf, sample, dsp->lpFMtaps, dsp->ws_lpFM);
         if (dsp->opt_iq < 2) s = s_fm;
     }
 
+    *ps_fm = s_fm;
+    return s;
+}
+
+// IQ: z -> mix(Df), IF-lowpass, FM discriminator
+static float demod_sample(dsp_t *dsp, ui32_t sample, float complex z, float s, float *ps_fm) {
+    float complex w, z0;
+
+    if (dsp->opt_iq)
+    {
+        if (dsp->opt_dc && !dsp->opt_nolut)
+        {
+            z *= nco_exp(&dsp->nco_dc, -dsp->Df/(double)dsp->sr, sample);
+        }
+
+
+        // IF-lowpass
+        if (dsp->opt_lp & LP_IQ) {
+            dsp->lpIQ_buf[sample % dsp->lpIQtaps] = z;
+            z = lowpass(dsp->lpIQ_buf, sample, dsp->lpIQtaps, dsp->ws_lpIQ);
+        }
+
+
+        z0 = dsp->rot_iqbuf[(sample-1 + dsp->N_IQBUF) % dsp->N_IQBUF];
+        w = z * conj(z0);
+        s = FM_GAIN * atan2_poly(cimagf(w), crealf(w)) / M_PI;
+    }
+
+    return demod_fm(dsp, sample, z, s, ps_fm);
+}
+
+// IQ block (no opt_dc): IF-lowpass, discriminator over the block, then per sample
+static void demod_block(dsp_t *dsp, float complex *z, float *s, float *fm, int len) {
+    ui32_t sample = dsp->blk_in;
+    int k;
+
+    if (dsp->opt_lp & LP_IQ) {
+        for (k = 0; k < len; k++) {
+            dsp->lpIQ_buf[(sample+k) % dsp->lpIQtaps] = z[k];
+            z[k] = lowpass(dsp->lpIQ_buf, sample+k, dsp->lpIQtaps, dsp->ws_lpIQ);
+        }
+    }
+
+    fm_disc_blk(z, dsp->rot_iqbuf[(sample-1 + dsp->N_IQBUF) % dsp->N_IQBUF], fm, len);
+
+    for (k = 0; k < len; k++) {
+        s[k] = demod_fm(dsp, sample+k, z[k], fm[k], fm+k);
+    }
+    dsp->blk_in += len;
+}
+
+// block front end: one fread per block; read/convert/mix/decimate and,
+// if nothing feeds back into the demodulator (no opt_dc), also IQ/FM demod.
+// dsp->blk_in runs ahead of dsp->sample_in, f32buf_sample() consumes.
+static int f32buf_block(dsp_t *dsp, int n) {
+    int k, len;
+    int bps = dsp->bps/8;
+
+    size_t cnt;
+    ui8_t *raw;
+
+    if (dsp->opt_iq == 5)
+    {
+        raw = dsp_fblock(dsp, bps, 2*n*dsp->decM, &cnt);
+        len = cnt / (2*dsp->decM);
+        f32conv_cblock(dsp, raw, dsp->blk_zi, len*dsp->decM, 1);
+        for (k = 0; k < len; k++) {
+            dsp->blk_z[k] = decimate(dsp, dsp->blk_zi + k*dsp->decM, dsp->blk_in+k);
+        }
+        if (dsp->blk_full) demod_block(dsp, dsp->blk_z, dsp->blk_s, dsp->blk_fm, len);
+        else dsp->blk_in += len;
+    }
+    else if (dsp->opt_iq)
+    {
+        raw = dsp_fblock(dsp, bps, 2*n, &cnt);
+        len = cnt / 2;
+        f32conv_cblock(dsp, raw, dsp->blk_z, len, dsp->opt_iqdc);
+        if (dsp->blk_full) demod_block(dsp, dsp->blk_z, dsp->blk_s, dsp->blk_fm, len);
+        else dsp->blk_in += len;
+    }
+    else
+    {
+        int nch = dsp->nch;
+        float *s = dsp->blk_s; // converted channel, then demod in place
+        raw = dsp_fblock(dsp, bps, nch*n, &cnt);
+        len = cnt / nch;
+        if (bps == 4) {
+            const float *f = (const float*)raw + dsp->ch;
+            for (k = 0; k < len; k++) s[k] = f[k*nch];
+        }
+        else if (bps == 2) {
+            const short *b = (const short*)raw + dsp->ch;
+            for (k = 0; k < len; k++) s[k] = b[k*nch]/32768.0;
+        }
+        else {
+            const ui8_t *u = raw + dsp->ch;
+            for (k = 0; k < len; k++) s[k] = (u[k*nch]-128)/128.0;
+        }
+        for (k = 0; k < len; k++) {
+            s[k] = demod_sample(dsp, dsp->blk_in, 0, s[k], dsp->blk_fm+k);
+            dsp->blk_in += 1;
+        }
+    }
+
+    dsp->blk_len = len;
+    dsp->blk_pos = 0;
+
+    return len;
+}
+
+int f32buf_sample(dsp_t *dsp, int inv) {
+    float s = 0.0;
+    float s_fm = s;
+    float xneu, xalt;
+
+    float complex z = 0;
+
+    if (dsp->opt_blk)
+    {
+        if (dsp->blk_pos >= dsp->blk_len) {
+            if (f32buf_block(dsp, dsp->blk_n) <= 0) return EOF;
+        }
+        if (dsp->blk_full) {
+            s    = dsp->blk_s[dsp->blk_pos];
+            s_fm = dsp->blk_fm[dsp->blk_pos];
+        }
+        else {
+            s = demod_sample(dsp, dsp->sample_in, dsp->blk_z[dsp->blk_pos], 0, &s_fm);
+        }
+        dsp->blk_pos += 1;
+    }
+    else
+    {
+        if (dsp->opt_iq)
+        {
+            if (dsp->opt_iq == 5) {
+                if ( f32read_cblock(dsp) < dsp->decM ) return EOF;
+                z = decimate(dsp, dsp->decMbuf, dsp->sample_in);
+            }
+            else if ( f32read_csample(dsp, &z) == EOF ) return EOF;
+        }
+        else {
+            if (f32read_sample(dsp, &s) == EOF) return EOF;
+        }
+        s = demod_sample(dsp, dsp->sample_in, z, s, &s_fm);
+    }
+
     dsp->fm_buffer[dsp->sample_in % dsp->M] = s_fm;
 
     if (inv) s = -s;
@@ -1203,7 +1889,14 @@ int init_buffers(dsp_t *dsp) {
     int K, L, M;
     int n, k;
     float *m = NULL;
+    tabcache_t tc;
+    int ret = -1;
+
+
+    // replay segment: seg_lim mmap only, stdio would decode to EOF
+    if (dsp_mmap(dsp) < 0 && dsp->seg_lim > 0) return -1;
 
+    tab_open(&tc, dsp); // key: input parameters (before decimation)
 
     // decimate
     if (dsp->opt_iq == 5)
@@ -1231,8 +1924,8 @@ int init_buffers(dsp_t *dsp) {
         t_bw /= sr_base;
         taps = 4.0/t_bw; if (taps%2==0) taps++;
 
-        taps = lowpass_init(f_lp, taps, &ws_dec); // decimate lowpass
-        if (taps < 0) return -1;
+        taps = lowpass_tab(&tc, f_lp, taps, &ws_dec); // decimate lowpass
+        if (taps < 0) goto exit_tab;
         dsp->dectaps = (ui32_t)taps;
 
         dsp->sr_base = sr_base;
@@ -1275,18 +1968,26 @@ int init_buffers(dsp_t *dsp) {
             f0 = freq0 / (double)dsp->sr_base;
 
             dsp->ex = calloc(dsp->lut_len+1, sizeof(float complex));
-            if (dsp->ex == NULL) return -1;
-            for (n = 0; n < dsp->lut_len; n++) {
-                t = f0*(double)n;
-                dsp->ex[n] = cexp(t*_2PI*I);
+            if (dsp->ex == NULL) goto exit_tab;
+            if (tab_get(&tc, dsp->ex, dsp->lut_len*sizeof(float complex))) {
+                for (n = 0; n < dsp->lut_len; n++) {
+                    t = f0*(double)n;
+                    dsp->ex[n] = cexp(t*_2PI*I);
+                }
+                tab_put(&tc, dsp->ex, dsp->lut_len*sizeof(float complex));
             }
         }
 
         dsp->decXbuffer = calloc( dsp->dectaps+1, sizeof(float complex));
-        if (dsp->decXbuffer == NULL) return -1;
+        if (dsp->decXbuffer == NULL) goto exit_tab;
+
+        dsp->decXre = calloc( 2*dsp->dectaps+1, sizeof(float));
+        if (dsp->decXre == NULL) goto exit_tab;
+        dsp->decXim = calloc( 2*dsp->dectaps+1, sizeof(float));
+        if (dsp->decXim == NULL) goto exit_tab;
 
         dsp->decMbuf = calloc( dsp->decM+1, sizeof(float complex));
-        if (dsp->decMbuf == NULL) return -1;
+        if (dsp->decMbuf == NULL) goto exit_tab;
     }
 
     // IF lowpass
@@ -1298,13 +1999,13 @@ int init_buffers(dsp_t *dsp) {
         f_lp = 24e3/(float)dsp->sr/2.0; // default
         if (dsp->lpIQ_bw) f_lp = dsp->lpIQ_bw/(float)dsp->sr/2.0;
         taps = 4*dsp->sr/IF_TRANSITION_BW; if (taps%2==0) taps++;
-        taps = lowpass_init(1.5*f_lp, taps, &dsp->ws_lpIQ0); if (taps < 0) return -1;
-        taps = lowpass_init(f_lp, taps, &dsp->ws_lpIQ1); if (taps < 0) return -1;
+        taps = lowpass_tab(&tc, 1.5*f_lp, taps, &dsp->ws_lpIQ0); if (taps < 0) goto exit_tab;
+        taps = lowpass_tab(&tc, f_lp, taps, &dsp->ws_lpIQ1); if (taps < 0) goto exit_tab;
 
         dsp->lpIQ_fbw = f_lp;
         dsp->lpIQtaps = taps;
         dsp->lpIQ_buf = calloc( dsp->lpIQtaps+3, sizeof(float complex));
-        if (dsp->lpIQ_buf == NULL) return -1;
+        if (dsp->lpIQ_buf == NULL) goto exit_tab;
 
         dsp->ws_lpIQ = dsp->ws_lpIQ1;
         // dc-offset: if not centered, (acquisition) filter bw = lpIQ_bw + 4kHz
@@ -1327,11 +2028,11 @@ int init_buffers(dsp_t *dsp) {
         f_lp = 10e3/(float)dsp->sr; // default
         if (dsp->lpFM_bw > 0) f_lp = dsp->lpFM_bw/(float)dsp->sr;
         taps = 4*dsp->sr/FM_TRANSITION_BW; if (taps%2==0) taps++;
-        taps = lowpass_init(f_lp, taps, &dsp->ws_lpFM); if (taps < 0) return -1;
+        taps = lowpass_tab(&tc, f_lp, taps, &dsp->ws_lpFM); if (taps < 0) goto exit_tab;
 
         dsp->lpFMtaps = taps;
         dsp->lpFM_buf = calloc( dsp->lpFMtaps+3, sizeof(float complex));
-        if (dsp->lpFM_buf == NULL) return -1;
+        if (dsp->lpFM_buf == NULL) goto exit_tab;
     }
 
 
@@ -1370,72 +2071,94 @@ int init_buffers(dsp_t *dsp) {
     dsp->Nvar = L; // wenn Nvar fuer xnorm, dann Nvar=rshd.L
 
 
-    dsp->bufs  = (float *)calloc( M+1, sizeof(float)); if (dsp->bufs  == NULL) return -100;
-    dsp->match = (float *)calloc( L+1, sizeof(float)); if (dsp->match == NULL) return -100;
+    dsp->bufs  = (float *)calloc( M+1, sizeof(float)); if (dsp->bufs  == NULL) { ret = -100; goto exit_tab; }
+    dsp->match = (float *)calloc( L+1, sizeof(float)); if (dsp->match == NULL) { ret = -100; goto exit_tab; }
 
-    dsp->xs = (float *)calloc( M+1, sizeof(float)); if (dsp->xs == NULL) return -100;
-    dsp->qs = (float *)calloc( M+1, sizeof(float)); if (dsp->qs == NULL) return -100;
+    dsp->xs = (float *)calloc( M+1, sizeof(float)); if (dsp->xs == NULL) { ret = -100; goto exit_tab; }
+    dsp->qs = (float *)calloc( M+1, sizeof(float)); if (dsp->qs == NULL) { ret = -100; goto exit_tab; }
 
-    dsp->rawbits = (char *)calloc( 2*dsp->hdrlen+1, sizeof(char)); if (dsp->rawbits == NULL) return -100;
+    dsp->rawbits = (char *)calloc( 2*dsp->hdrlen+1, sizeof(char)); if (dsp->rawbits == NULL) { ret = -100; goto exit_tab; }
 
 
     for (i = 0; i < M; i++) dsp->bufs[i] = 0.0;
 
 
-    for (i = 0; i < L; i++) {
-        pos = i/dsp->sps;
-        t = (i - pos*dsp->sps)/dsp->sps - 0.5;
+    if (tab_get(&tc, dsp->match, L*sizeof(float))) {
+        for (i = 0; i < L; i++) {
+            pos = i/dsp->sps;
+            t = (i - pos*dsp->sps)/dsp->sps - 0.5;
 
-        b1 = ((dsp->hdr[pos] & 0x1) - 0.5)*2.0;
-        b = b1*pulse(t, sigma);
+            b1 = ((dsp->hdr[pos] & 0x1) - 0.5)*2.0;
+            b = b1*pulse(t, sigma);
 
-        if (pos > 0) {
-            b0 = ((dsp->hdr[pos-1] & 0x1) - 0.5)*2.0;
-            b += b0*pulse(t+1, sigma);
-        }
+            if (pos > 0) {
+                b0 = ((dsp->hdr[pos-1] & 0x1) - 0.5)*2.0;
+                b += b0*pulse(t+1, sigma);
+            }
 
-        if (pos < dsp->hdrlen-1) {
-            b2 = ((dsp->hdr[pos+1] & 0x1) - 0.5)*2.0;
-            b += b2*pulse(t-1, sigma);
-        }
+            if (pos < dsp->hdrlen-1) {
+                b2 = ((dsp->hdr[pos+1] & 0x1) - 0.5)*2.0;
+                b += b2*pulse(t-1, sigma);
+            }
 
-        dsp->match[i] = b;
-    }
+            dsp->match[i] = b;
+        }
 
-    normMatch = sqrt( norm2_vect(dsp->match, L) );
-    for (i = 0; i < L; i++) {
-        dsp->match[i] /= normMatch;
+        normMatch = sqrt( norm2_vect(dsp->match, L) );
+        for (i = 0; i < L; i++) {
+            dsp->match[i] /= normMatch;
+        }
+        tab_put(&tc, dsp->match, L*sizeof(float));
     }
 
 
-    dsp->DFT.xn = calloc(dsp->DFT.N+1, sizeof(float));  if (dsp->DFT.xn == NULL) return -1;
+    dsp->DFT.xn = calloc(dsp->DFT.N+1, sizeof(float));  if (dsp->DFT.xn == NULL) goto exit_tab;
 
-    dsp->DFT.Fm = calloc(dsp->DFT.N+1, sizeof(float complex));  if (dsp->DFT.Fm == NULL) return -1;
-    dsp->DFT.X  = calloc(dsp->DFT.N+1, sizeof(float complex));  if (dsp->DFT.X  == NULL) return -1;
-    dsp->DFT.Z  = calloc(dsp->DFT.N+1, sizeof(float complex));  if (dsp->DFT.Z  == NULL) return -1;
-    dsp->DFT.cx = calloc(dsp->DFT.N+1, sizeof(float complex));  if (dsp->DFT.cx == NULL) return -1;
+    dsp->DFT.Fm = calloc(dsp->DFT.N+1, sizeof(float complex));  if (dsp->DFT.Fm == NULL) goto exit_tab;
+    dsp->DFT.X  = calloc(dsp->DFT.N+1, sizeof(float complex));  if (dsp->DFT.X  == NULL) goto exit_tab;
+    dsp->DFT.Z  = calloc(dsp->DFT.N+1, sizeof(float complex));  if (dsp->DFT.Z  == NULL) goto exit_tab;
+    dsp->DFT.cx = calloc(dsp->DFT.N+1, sizeof(float complex));  if (dsp->DFT.cx == NULL) goto exit_tab;
 
-    dsp->DFT.ew = calloc(dsp->DFT.LOG2N+1, sizeof(float complex));  if (dsp->DFT.ew == NULL) return -1;
+    dsp->DFT.ew = calloc(dsp->DFT.LOG2N+1, sizeof(float complex));  if (dsp->DFT.ew == NULL) goto exit_tab;
 
     // FFT window
     // a) N2 = N
     // b) N2 < N (interpolation)
-    dsp->DFT.win = calloc(dsp->DFT.N+1, sizeof(float complex));  if (dsp->DFT.win == NULL) return -1; // float real
+    dsp->DFT.win = calloc(dsp->DFT.N+1, sizeof(float complex));  if (dsp->DFT.win == NULL) goto exit_tab; // float real
     dsp->DFT.N2 = dsp->DFT.N;
     //dsp->DFT.N2 = dsp->DFT.N/2 - 1; // N=2^log2N
-    dft_window(&dsp->DFT, 1);
+    if (tab_get(&tc, dsp->DFT.win, dsp->DFT.N*sizeof(*dsp->DFT.win))) {
+        dft_window(&dsp->DFT, 1);
+        tab_put(&tc, dsp->DFT.win, dsp->DFT.N*sizeof(*dsp->DFT.win));
+    }
 
-    for (n = 0; n < dsp->DFT.LOG2N; n++) {
-        k = 1 << n;
-        dsp->DFT.ew[n] = cexp(-I*M_PI/(float)k);
+    if (tab_get(&tc, dsp->DFT.ew, dsp->DFT.LOG2N*sizeof(float complex))) {
+        for (n = 0; n < dsp->DFT.LOG2N; n++) {
+            k = 1 << n;
+            dsp->DFT.ew[n] = cexp(-I*M_PI/(float)k);
+        }
+        tab_put(&tc, dsp->DFT.ew, dsp->DFT.LOG2N*sizeof(float complex));
     }
 
-    m = calloc(dsp->DFT.N+1, sizeof(float));  if (m  == NULL) return -1;
-    for (i = 0; i < L; i++) m[L-1 - i] = dsp->match[i]; // t = L-1
-    while (i < dsp->DFT.N) m[i++] = 0.0;
-    rdft(&dsp->DFT, m, dsp->DFT.Fm);
+    dsp->DFT.brv = calloc(dsp->DFT.N+1, sizeof(int));  if (dsp->DFT.brv == NULL) goto exit_tab;
+    dsp->DFT.tw  = calloc(dsp->DFT.N+1, sizeof(float complex));  if (dsp->DFT.tw == NULL) goto exit_tab;
+    if (tab_get(&tc, dsp->DFT.brv, dsp->DFT.N*sizeof(int)) || tab_get(&tc, dsp->DFT.tw, dsp->DFT.N*sizeof(float complex))) {
+        dft_tables(&dsp->DFT);
+        tab_put(&tc, dsp->DFT.brv, dsp->DFT.N*sizeof(int));
+        tab_put(&tc, dsp->DFT.tw, dsp->DFT.N*sizeof(float complex));
+    }
 
-    free(m); m = NULL;
+    if (tab_get(&tc, dsp->DFT.Fm, dsp->DFT.N*sizeof(float complex))) {
+        m = calloc(dsp->DFT.N+1, sizeof(float));  if (m  == NULL) goto exit_tab;
+        for (i = 0; i < L; i++) m[L-1 - i] = dsp->match[i]; // t = L-1
+        while (i < dsp->DFT.N) m[i++] = 0.0;
+        rdft(&dsp->DFT, m, dsp->DFT.Fm);
+        tab_put(&tc, dsp->DFT.Fm, dsp->DFT.N*sizeof(float complex));
+
+        free(m); m = NULL;
+    }
+
+    tab_close(&tc);
 
 
     if (dsp->opt_iq)
@@ -1455,9 +2178,41 @@ int init_buffers(dsp_t *dsp) {
         double f2 = -f1;
         dsp->iw1 = _2PI*I*f1;
         dsp->iw2 = _2PI*I*f2;
+        nco_set(&dsp->nco_f1, -f1/(double)dsp->sr, 0);
+        nco_set(&dsp->nco_f2, -f2/(double)dsp->sr, 0);
+        dsp->dw1 = cexp(dsp->iw1*(int)dsp->sps/(double)dsp->sr);
+        dsp->dw2 = cexp(dsp->iw2*(int)dsp->sps/(double)dsp->sr);
+    }
+    nco_set(&dsp->nco_dc, 0.0, 0);
+    nco_set(&dsp->nco_mix, dsp->xlt_fq, 0);
+
+    // block front end
+    // opt_dc: find_header() updates Df, rot_iqbuf, F1sum/F2sum, ws_lpIQ -> IQ demod per sample
+    if (dsp->opt_iq == 5 && dsp->opt_nolut && dsp->opt_dc) dsp->opt_blk = 0; // Df in mixer
+    if (dsp->opt_blk)
+    {
+        int decM = (dsp->opt_iq == 5) ? dsp->decM : 1;
+        int nch  = (dsp->nch > 2) ? dsp->nch : 2;
+
+        dsp->blk_full = !(dsp->opt_iq && dsp->opt_dc);
+        dsp->blk_n = (F32BLK + decM-1) / decM;
+        dsp->blk_len = 0;
+        dsp->blk_pos = 0;
+        dsp->blk_in = 0;
+
+        dsp->blk_raw = calloc(dsp->blk_n*decM*nch*4+1, 1);  if (dsp->blk_raw == NULL) return -1;
+        dsp->blk_zi = calloc(dsp->blk_n*decM+1, sizeof(float complex));  if (dsp->blk_zi == NULL) return -1;
+        dsp->blk_z  = calloc(dsp->blk_n+1, sizeof(float complex));  if (dsp->blk_z  == NULL) return -1;
+        dsp->blk_s  = calloc(dsp->blk_n+1, sizeof(float));  if (dsp->blk_s  == NULL) return -1;
+        dsp->blk_fm = calloc(dsp->blk_n+1, sizeof(float));  if (dsp->blk_fm == NULL) return -1;
     }
 
     return K;
+
+exit_tab:
+    tc.err = 1;  // incomplete, tmp removed
+    tab_close(&tc);
+    return ret;
 }
 
 int free_buffers(dsp_t *dsp) {
@@ -1474,6 +2229,8 @@ int free_buffers(dsp_t *dsp) {
     if (dsp->DFT.X)  { free(dsp->DFT.X);  dsp->DFT.X  = NULL; }
     if (dsp->DFT.Z)  { free(dsp->DFT.Z);  dsp->DFT.Z  = NULL; }
     if (dsp->DFT.cx) { free(dsp->DFT.cx); dsp->DFT.cx = NULL; }
+    if (dsp->DFT.brv) { free(dsp->DFT.brv); dsp->DFT.brv = NULL; }
+    if (dsp->DFT.tw) { free(dsp->DFT.tw); dsp->DFT.tw = NULL; }
 
     if (dsp->DFT.win) { free(dsp->DFT.win); dsp->DFT.win = NULL; }
 
@@ -1487,6 +2244,8 @@ int free_buffers(dsp_t *dsp) {
     if (dsp->opt_iq == 5)
     {
         if (dsp->decXbuffer) { free(dsp->decXbuffer); dsp->decXbuffer = NULL; }
+        if (dsp->decXre)     { free(dsp->decXre);     dsp->decXre     = NULL; }
+        if (dsp->decXim)     { free(dsp->decXim);     dsp->decXim     = NULL; }
         if (dsp->decMbuf)    { free(dsp->decMbuf);    dsp->decMbuf    = NULL; }
         if (!dsp->opt_nolut) {
             if (dsp->ex)     { free(dsp->ex);         dsp->ex         = NULL; }
@@ -1511,11 +2270,25 @@ int free_buffers(dsp_t *dsp) {
 
     if (dsp->fm_buffer) { free(dsp->fm_buffer); dsp->fm_buffer = NULL; }
 
+    // block front end
+    if (dsp->opt_blk)
+    {
+        if (dsp->blk_raw) { free(dsp->blk_raw); dsp->blk_raw = NULL; }
+        if (dsp->blk_zi)  { free(dsp->blk_zi);  dsp->blk_zi  = NULL; }
+        if (dsp->blk_z)   { free(dsp->blk_z);   dsp->blk_z   = NULL; }
+        if (dsp->blk_s)   { free(dsp->blk_s);   dsp->blk_s   = NULL; }
+        if (dsp->blk_fm)  { free(dsp->blk_fm);  dsp->blk_fm  = NULL; }
+    }
+
+    dsp_munmap(dsp);
+    shm_detach(dsp);
+
     return 0;
 }
 
 /* ------------------------------------------------------------------------------------ */
 
+static void replay_idx(dsp_t *dsp, size_t pos);
 
 int find_header(dsp_t *dsp, float thres, int hdmax, int bitofs, int opt_dc) {
     ui32_t k = 0;
@@ -1554,16 +2327,20 @@ int find_header(dsp_t *dsp, float thres, int hdmax, int bitofs, int opt_dc) {
                             float complex X2 = 0;
                             float complex _z = 0;
                             int _n = dsp->sps;
+                            nco_t _r, _e1, _e2;
+                            nco_set(&_r,  -diffDf/(double)dsp->sr, dsp->sample_in - _n);
+                            nco_set(&_e1, dsp->nco_f1.f, dsp->sample_in - _n);
+                            nco_set(&_e2, dsp->nco_f2.f, dsp->sample_in - _n);
                             while ( _n > 0 )
                             {
                                 // update rot_iqbuf
-                                double _tn = (dsp->sample_in - _n) / (double)dsp->sr;
-                                dsp->rot_iqbuf[(dsp->sample_in - _n + dsp->N_IQBUF) % dsp->N_IQBUF] *= cexp(-_tn*_2PI*diffDf*I);
+                                ui32_t _sn = dsp->sample_in - _n;
+                                dsp->rot_iqbuf[(_sn + dsp->N_IQBUF) % dsp->N_IQBUF] *= nco_exp(&_r, _r.f, _sn);
                                 //
                                 //update/reset F1sum, F2sum
-                                _z = dsp->rot_iqbuf[(dsp->sample_in - _n + dsp->N_IQBUF) % dsp->N_IQBUF];
-                                X1 += _z*cexp(-_tn*dsp->iw1);
-                                X2 += _z*cexp(-_tn*dsp->iw2);
+                                _z = dsp->rot_iqbuf[(_sn + dsp->N_IQBUF) % dsp->N_IQBUF];
+                                X1 += _z*nco_exp(&_e1, _e1.f, _sn);
+                                X2 += _z*nco_exp(&_e2, _e2.f, _sn);
                                 _n--;
                             }
                             dsp->F1sum = X1;
@@ -1594,6 +2371,22 @@ int find_header(dsp_t *dsp, float thres, int hdmax, int bitofs, int opt_dc) {
                 herrs = headcmp(dsp, opt_dc);
                 if (herrs <= hdmax) header_found = 1; // max bitfehler in header
 
+                if (header_found && dsp->seg_end > 0) {
+                    // replay segment: input sample position of header
+                    size_t pos = dsp->seg_ofs + (size_t)dsp->mv_pos * (dsp->decM > 1 ? dsp->decM : 1);
+                    if (pos >= dsp->seg_end + dsp->seg_ovl) return EOF; // next segment
+                    if (pos + dsp->seg_ovl >= dsp->seg_beg) {
+                        fflush(stdout);
+                        if (dsp->seg_fd >= 0) {
+                            // end of pre-roll: frames to segment output
+                            dup2(dsp->seg_fd, STDOUT_FILENO);
+                            close(dsp->seg_fd);
+                            dsp->seg_fd = -1;
+                        }
+                        replay_idx(dsp, pos);
+                    }
+                }
+
                 if (header_found) return 1;
             }
         }
@@ -1603,6 +2396,185 @@ int find_header(dsp_t *dsp, float thres, int hdmax, int bitofs, int opt_dc) {
     return EOF;
 }
 
+/* ------------------------------------------------------------------------------------ */
+/*
+ *  offline replay: input file split into jobs segments, one process per segment.
+ *  segment j decodes [seg_beg-REPLAY_PRE, seg_end+REPLAY_POST], output muted
+ *  until first header >= seg_beg-REPLAY_OVL, EOF at first header >= seg_end+REPLAY_OVL.
+ *  The header position can differ by a few samples between segments,
+ *  so frames near a boundary are decoded by both segments:
+ *  index (header position, output offset) per frame, segment outputs (tmpfile)
+ *  copied to stdout in order, frames of segment j+1 already in segment j skipped.
+ *  return: 0 continue decoding (child, or no replay), 1 parent done, -1 error
+ */
+
+typedef struct {
+    size_t pos;  // header, input sample
+    off_t  off;  // segment output
+} seg_rec_t;
+
+static void replay_idx(dsp_t *dsp, size_t pos) {
+    seg_rec_t r;
+    r.pos = pos;
+    r.off = lseek(STDOUT_FILENO, 0, SEEK_CUR);
+    if (r.off < 0 || write(dsp->seg_idx, &r, sizeof(r)) != sizeof(r)) {
+        fprintf(stderr, "error: replay index\n");
+    }
+}
+
+static seg_rec_t *replay_readidx(FILE *fi, size_t *n) {
+    struct stat st;
+    seg_rec_t *rec;
+
+    *n = 0;
+    if (fstat(fileno(fi), &st) != 0) return NULL;
+    rec = calloc(st.st_size / sizeof(seg_rec_t) + 1, sizeof(seg_rec_t));
+    if (rec == NULL) return NULL;
+    rewind(fi);
+    *n = fread(rec, sizeof(seg_rec_t), st.st_size / sizeof(seg_rec_t), fi);
+    return rec;
+}
+
+static void replay_copy(FILE *fo, off_t beg, off_t end, char *buf, size_t len) {
+    size_t n;
+    fseeko(fo, beg, SEEK_SET);
+    while (beg < end) {
+        n = (end - beg < (off_t)len) ? (size_t)(end - beg) : len;
+        n = fread(buf, 1, n, fo);
+        if (n == 0) break;
+        fwrite(buf, 1, n, stdout);
+        beg += n;
+    }
+}
+
+// header position in previous segment (sorted)
+static int replay_dup(seg_rec_t *prev, size_t n, size_t pos, size_t tol) {
+    while (n > 0) {
+        n--;
+        if (prev[n].pos > pos + tol) continue;
+        return prev[n].pos + tol >= pos;
+    }
+    return 0;
+}
+
+int replay_jobs(dsp_t *dsp, int jobs) {
+    struct stat st;
+    long ofs;
+    size_t align, nsmp, seg, pre, post, ovl, tol;
+    FILE *out[REPLAY_MAXJOBS];
+    FILE *idx[REPLAY_MAXJOBS];
+    seg_rec_t *rec, *prev = NULL;
+    size_t nrec, nprev = 0, k;
+    off_t end;
+    pid_t pid[REPLAY_MAXJOBS];
+    char buf[1<<14];
+    size_t n;
+    int j, status;
+    int err = 0;
+
+    if (jobs < 2) return 0;
+    if (jobs > REPLAY_MAXJOBS) jobs = REPLAY_MAXJOBS;
+
+    if (dsp->shm || dsp->fp == NULL || fstat(fileno(dsp->fp), &st) != 0 || !S_ISREG(st.st_mode)) {
+        fprintf(stderr, "note: --jobs needs input file\n");
+        return 0;
+    }
+    // segments: mmap, one position per process (stdio: file offset shared after fork())
+    if (dsp_mmap(dsp) < 0) {
+        fprintf(stderr, "note: --jobs needs mmap input\n");
+        return 0;
+    }
+    dsp_munmap(dsp);
+    ofs = ftell(dsp->fp);
+    align = dsp->nch * (dsp->bps/8);
+    if (ofs < 0 || align == 0) return 0;
+
+    nsmp = (st.st_size - ofs) / align;
+    pre  = REPLAY_PRE  * dsp->sr;
+    post = REPLAY_POST * dsp->sr;
+    ovl  = REPLAY_OVL  * dsp->sr;
+    tol  = REPLAY_DUP  * dsp->sr / dsp->br;
+
+    // segments not shorter than pre-roll
+    if (nsmp / jobs < pre) jobs = nsmp / pre;
+    if (jobs < 2) return 0;
+    // segment start seg_ofs: multiple of 4 samples,
+    // i.e. byte offset seg_ofs*align keeps the 4-byte alignment of the data chunk (mmap)
+    seg = (nsmp / jobs) & ~(size_t)3;
+    pre &= ~(size_t)3;
+
+    fprintf(stderr, "replay: %d jobs, %.1f sec/segment\n", jobs, seg/(double)dsp->sr);
+    fflush(stdout);
+    fflush(stderr);
+
+    for (j = 0; j < jobs; j++) {
+        out[j] = tmpfile();
+        if (out[j] == NULL) { err = -1; break; }
+        idx[j] = tmpfile();
+        if (idx[j] == NULL) { fclose(out[j]); err = -1; break; }
+
+        pid[j] = fork();
+        if (pid[j] < 0) { fclose(out[j]); fclose(idx[j]); err = -1; break; }
+
+        if (pid[j] == 0) {
+            int fd = open("/dev/null", O_WRONLY);
+            if (fd < 0) _exit(1);
+
+            dsp->seg_beg = j*seg;
+            dsp->seg_end = (j < jobs-1) ? (j+1)*seg : nsmp;
+            dsp->seg_ofs = (dsp->seg_beg > pre) ? dsp->seg_beg - pre : 0;
+            dsp->seg_ovl = ovl;
+            dsp->seg_lim = ofs + (dsp->seg_end + post) * align;
+            dsp->seg_idx = fileno(idx[j]);
+            dsp->seg_fd = dup(fileno(out[j]));
+            if (dsp->seg_fd < 0) _exit(1);
+
+            dup2(fd, STDOUT_FILENO); // pre-roll
+            close(fd);
+            if (dsp->seg_beg == 0) {
+                dup2(dsp->seg_fd, STDOUT_FILENO);
+                close(dsp->seg_fd);
+                dsp->seg_fd = -1;
+            }
+
+            fseek(dsp->fp, ofs + dsp->seg_ofs * align, SEEK_SET);
+            return 0;
+        }
+    }
+    if (err) jobs = j;
+
+    for (j = 0; j < jobs; j++) {
+        if (waitpid(pid[j], &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) err = -1;
+        rec = replay_readidx(idx[j], &nrec);
+        fseeko(out[j], 0, SEEK_END);
+        end = ftello(out[j]);
+        if (rec == NULL || end < 0) {
+            err = -1;
+            rewind(out[j]);
+            while ( (n = fread(buf, 1, sizeof(buf), out[j])) > 0 ) fwrite(buf, 1, n, stdout);
+        }
+        else {
+            // output of frame k: [rec[k].off, rec[k+1].off)
+            replay_copy(out[j], 0, nrec > 0 ? rec[0].off : end, buf, sizeof(buf));
+            for (k = 0; k < nrec; k++) {
+                if (replay_dup(prev, nprev, rec[k].pos, tol)) continue;
+                replay_copy(out[j], rec[k].off, k+1 < nrec ? rec[k+1].off : end, buf, sizeof(buf));
+            }
+        }
+        free(prev);
+        prev = rec;
+        nprev = nrec;
+        fclose(out[j]);
+        fclose(idx[j]);
+    }
+    free(prev);
+    fflush(stdout);
+
+    if (err) fprintf(stderr, "error: replay\n");
+
+    return err ? -1 : 1;
+}
+
 /* ------------------------------------------------------------------------------------ */
 
 
@@ -1620,6 +2592,10 @@ int free_buffers(dsp_t *dsp) {}
 
 int find_header(dsp_t *dsp, float thres, int hdmax, int bitofs, int opt_dc) {}
 
+int replay_jobs(dsp_t *dsp, int jobs) {}
+
+int shm_attach(dsp_t *dsp, pcm_t *pcm, char *name) {}
+
 #endif
 
 
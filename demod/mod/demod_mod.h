@@ -38,9 +38,41 @@ typedef struct {
     float complex  *Z;
     float complex  *cx;
     float complex  *win; // float real
+    int *brv;            // bit-reversal table
+    float complex  *tw;  // twiddles: tw[l2-1+j] = exp(-I*pi*j/l2)
 } dft_t;
 
 
+// NCO: z = exp(2pi*I*f*n), recursive, exact phase every NCO_SEED samples
+typedef struct {
+    double f;           // cycles/sample
+    double complex z;
+    double complex w;   // exp(2pi*I*f)
+    ui32_t n;           // next sample
+    int k;
+} nco_t;
+
+
+// IQ shared memory ring: iq_shm (writer) -> decoders --shm <name> (readers)
+// [shm_hdr_t: SHM_HDRLEN][ring: size bytes], stream position wpos = bytes written
+#define SHM_MAGIC  0x31514953  // "SIQ1"
+#define SHM_HDRLEN 4096
+#define SHM_MAXRD  16
+
+typedef struct {
+    ui32_t magic;
+    ui32_t sr;
+    ui32_t bps;
+    ui32_t nch;
+    ui64_t size;        // ring, multiple of page size and IQ sample size
+    ui32_t wr_pid;
+    ui32_t eof;
+    ui64_t wpos;        // writer: bytes written (sequence), ring offset wpos % size
+    ui32_t rd_pid[SHM_MAXRD];  // reader slots, 0: free
+    ui64_t rd_pos[SHM_MAXRD];  // reader: start of the block in use
+} shm_hdr_t;
+
+
 typedef struct {
     FILE *fp;
     //
@@ -88,6 +120,10 @@ typedef struct {
     //
     double complex iw1;
     double complex iw2;
+    nco_t nco_f1;       // exp(-t*iw1)
+    nco_t nco_f2;       // exp(-t*iw2)
+    double complex dw1; // exp(sps*iw1/sr): t-sps/sr
+    double complex dw2;
 
 
     //
@@ -108,6 +144,7 @@ typedef struct {
     double dc;
     double Df;
     double dDf;
+    nco_t nco_dc;       // exp(-t*2pi*Df*I)
     //
 
     ui32_t sample_posframe;
@@ -119,6 +156,7 @@ typedef struct {
 
     // decimate
     int opt_nolut; // default: LUT
+    int opt_novec; // default: vector decimation lowpass
     int opt_IFmin;
     int decM;
     ui32_t sr_base;
@@ -127,9 +165,12 @@ typedef struct {
     ui32_t lut_len;
     ui32_t sample_decM;
     float complex *decXbuffer;
+    float *decXre; // linear delay line 2*dectaps, re/im
+    float *decXim;
     float complex *decMbuf;
     float complex *ex; // exp_lut
     double xlt_fq;
+    nco_t nco_mix;      // noLUT: xlt_fq - Df/sr_base
 
     // IF: lowpass
     int opt_lp;
@@ -148,6 +189,44 @@ typedef struct {
     float *lpFM_buf;
     float *fm_buffer;
 
+    // block front end: f32buf_block()
+    int opt_blk;
+    int blk_full; // incl. IQ/FM demod
+    int blk_n;
+    int blk_len;
+    int blk_pos;
+    ui32_t blk_in;
+    ui8_t *blk_raw;
+    float complex *blk_zi;
+    float complex *blk_z;
+    float *blk_s;
+    float *blk_fm;
+
+    // input: mmap (regular file)
+    ui8_t *map;
+    size_t map_len;
+    size_t map_pos;
+    size_t map_rel;
+    size_t map_end;
+    size_t map_chk;  // next file size check
+
+    // replay segment (--jobs)
+    size_t seg_ofs;  // first input sample, pre-roll
+    size_t seg_beg;  // output: frames with header in [seg_beg-seg_ovl, seg_end+seg_ovl)
+    size_t seg_end;
+    size_t seg_ovl;  // boundary overlap, duplicates removed in replay_jobs()
+    size_t seg_lim;  // input end (bytes)
+    int seg_fd;      // segment output; stdout muted until seg_beg-seg_ovl
+    int seg_idx;     // segment index: header position, output offset per frame
+
+    // input: shared memory ring (--shm)
+    shm_hdr_t *shm;
+    ui8_t *shm_buf;  // ring, mapped twice: blocks contiguous
+    int shm_rd;      // reader slot
+    ui64_t shm_pos;  // block in use
+    ui64_t shm_len;
+    ui64_t shm_lost; // overrun, bytes
+
 } dsp_t;
 
 
@@ -187,6 +266,10 @@ int free_buffers(dsp_t *);
 
 int find_header(dsp_t *, float, int, int, int);
 
+int replay_jobs(dsp_t *, int);
+
+int shm_attach(dsp_t *, pcm_t *, char *);
+
 int f32soft_read(FILE *fp, float *s);
 int find_binhead(FILE *fp, hdb_t *hdb, float *score);
 int find_softbinhead(FILE *fp, hdb_t *hdb, float *score);
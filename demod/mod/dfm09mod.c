@@ -224,41 +224,69 @@ static ui32_t bits2val(ui8_t *bits, int len) { // big endian
     return val;
 }
 
-static void deinterleave(hsbit_t *str, int L, hsbit_t *block) {
-    int i, j;
-    for (j = 0; j < B; j++) {  // L = 7, 13
-        for (i = 0; i < L; i++) {
-            block[B*i+j] = str[L*j+i];
+// Hamming(8,4)-Tabellen, Codewort gepackt: bit j = code[j]
+static ui8_t ham_cw8[16];     // codewords[n]
+static float ham_cws[16][8];  // codewords[n] -> +-1
+static int   ham_ret[256];    // 0: OK, j+1: 1-bit-error at j, -1: 2-bit-error
+static ui8_t ham_cor[256];    // hard decision
+static ui8_t ham_d2[256][4];  // 2-bit-error: the 4 codewords w/ dist=2
+
+static void init_hamtab(void) {
+    int w, n, i, j, k, ret;
+    ui8_t syn, s;
+
+    for (n = 0; n < 16; n++) {
+        ham_cw8[n] = 0;
+        for (i = 0; i < 8; i++) {
+            ham_cw8[n] |= codewords[n][i] << i;
+            ham_cws[n][i] = 2*codewords[n][i]-1;
         }
     }
-}
-
-static int check(int opt_ecc, hsbit_t code[8]) {
-    int i, j;               // Bei Demodulierung durch Nulldurchgaenge, wenn durch Fehler ausser Takt,
-    ui32_t synval = 0;      // verschieben sich die bits. Fuer Hamming-Decode waere es besser,
-    ui8_t syndrom[4];       // sync zu Beginn mit Header und dann Takt beibehalten fuer decision.
-    int ret=0;
+    for (w = 0; w < 256; w++) {
+        syn = 0;
+        for (i = 0; i < 4; i++) { // S = 4
+            s = 0;
+            for (j = 0; j < 8; j++) s ^= H[i][j] & (w>>j);
+            syn |= (s & 1) << (3-i);
+        }
+        ret = 0;
+        if (syn) {
+            ret = -1;
+            for (j = 0; j < 8; j++) {
+                if (syn == He[j]) { ret = j+1; break; }
+            }
+        }
+        ham_ret[w] = ret;
+        ham_cor[w] = (ret > 0) ? w ^ (1<<(ret-1)) : w;
 
-    for (i = 0; i < 4; i++) { // S = 4
-        syndrom[i] = 0;
-        for (j = 0; j < 8; j++) { // B = 8
-            syndrom[i] ^= H[i][j] & code[j].hb;
+        k = 0;
+        for (n = 0; n < 16 && k < 4; n++) {
+            ui8_t d = w ^ ham_cw8[n];
+            int dist = 0;
+            for (j = 0; j < 8; j++) dist += (d>>j) & 1;
+            if (dist == 2) ham_d2[w][k++] = n;
         }
     }
-    synval = bits2val(syndrom, 4);
-    if (synval) {
-        ret = -1;
-        for (j = 0; j < 8; j++) {   // 1-bit-error
-            if (synval == He[j]) {  // reicht auf databits zu pruefen, d.h.
-                ret = j+1;          // (systematischer Code) He[0..3]
-                break;
-            }
-        }
+}
+
+// L = 7, 13: codeword i = bits str[L*j+i], j=0..7
+static void deinterleave(hsbit_t *str, int L, ui8_t *cw) {
+    int i, j;
+    ui8_t w;
+    for (i = 0; i < L; i++) {
+        w = 0;
+        for (j = 0; j < B; j++) w |= (str[L*j+i].hb & 1) << j;
+        cw[i] = w;
     }
-    else ret = 0;
+}
+
+static int check(int opt_ecc, hsbit_t *str, int L, ui8_t *cw) {
+    int ret = ham_ret[*cw];   // Bei Demodulierung durch Nulldurchgaenge, wenn durch Fehler ausser Takt,
+                              // verschieben sich die bits. Fuer Hamming-Decode waere es besser,
+                              // sync zu Beginn mit Header und dann Takt beibehalten fuer decision.
 
-    if (ret > 0) code[ret-1].hb ^= 0x1; // d=1: 1-bit-error
-    else if (ret < 0 && opt_ecc == 2) { // d=2: 2-bit-error: soft decision
+    if (ret >= 0) *cw = ham_cor[*cw]; // d=1: 1-bit-error
+    else if (opt_ecc == 2) {          // d=2: 2-bit-error: soft decision
         // Hamming(8,4)
         // 256 words:
         //   16 codewords
@@ -266,57 +294,45 @@ static int check(int opt_ecc, hsbit_t code[8]) {
         //   16*7=112 2-error words (dist=2)
         //     each 2-error word has 4 codewords w/ dist=2,
         //     choose best match/correlation
-        int n;
-        int maxn = -1;
-        int d = 0;
-        float sum = 0.0;
+        //   softbits correlation:
+        //      - interleaving
+        //      + no pulse-shaping -> sum
+        float sb[8];
+        float sum[4];
         float maxsum = 0.0;
-        /*
-        sum = 0.0;                 // s<0: h=0 , s>0: h=1
-        for (i = 0; i < 8; i++) {  // h\in{0,1} -> 2h-1\in{-1,+1}
-            sum += (2*code[i].hb-1)*code[i].sb;  // i.e. sum_i |s_i|
-        } // original score
-        */
-        for (n = 0; n < 16; n++) {
-            d = 0;
-            for (i = 0; i < 8; i++) { // d(a,b) = sum_i a[i]^b[i]
-                if (code[i].hb != codewords[n][i]) d++;
-            }
-            if (d == 2) { // check dist=2 codewords - in principle, all codewords could be tested
-                // softbits correlation:
-                //      - interleaving
-                //      + no pulse-shaping -> sum
-                sum = 0.0;
-                for (i = 0; i < 8; i++) {
-                    sum += (2*codewords[n][i]-1) * code[i].sb;
-                }
-                if (sum >= maxsum) { // best match
-                    maxsum = sum;
-                    maxn = n;
-                }
-            }
-        }
-        if (maxn >= 0) {
-            for (i = 0; i < 8; i++) {
-                if (code[i].hb = codewords[maxn][i]);
+        int maxn = -1;
+        int i, k;
+        for (i = 0; i < 8; i++) sb[i] = str[L*i].sb;
+        for (k = 0; k < 4; k++) {
+            const float *c = ham_cws[ham_d2[*cw][k]];
+            sum[k] = 0.0;
+            for (i = 0; i < 8; i++) sum[k] += c[i] * sb[i];
+        }
+        for (k = 0; k < 4; k++) {
+            if (sum[k] >= maxsum) { // best match
+                maxsum = sum[k];
+                maxn = ham_d2[*cw][k];
             }
         }
+        if (maxn >= 0) *cw = ham_cw8[maxn];
     }
 
     return ret;
 }
 
-static int hamming(int opt_ecc, hsbit_t *ham, int L, ui8_t *sym) {
+static int hamming(int opt_ecc, hsbit_t *str, int L, ui8_t *sym) {
     int i, j;
     int ecc = 0, ret = 0;      // L = 7, 13
+    ui8_t cw[13];
+    deinterleave(str, L, cw);
     for (i = 0; i < L; i++) {  // L * 2 nibble (data+parity)
         if (opt_ecc) {
-            ecc = check(opt_ecc, ham+B*i);
+            ecc = check(opt_ecc, str+i, L, cw+i);
             if (ecc > 0) ret |= (1<<i);
             if (ecc < 0) ret |= ecc; // -1
         }
         for (j = 0; j < S; j++) {  // systematic: bits 0..S-1 data
-            sym[S*i+j] = ham[B*i+j].hb;
+            sym[S*i+j] = (cw[i]>>j) & 1;
         }
     }
     return ret;
@@ -1125,21 +1141,13 @@ static int print_frame(gpx_t *gpx) {
     int ret0, ret1, ret2;
     int ret = 0;
 
-    hsbit_t hamming_conf[ 7*B];  //  7*8=56
-    hsbit_t hamming_dat1[13*B];  // 13*8=104
-    hsbit_t hamming_dat2[13*B];
-
     ui8_t block_conf[ 7*S];  //  7*4=28
     ui8_t block_dat1[13*S];  // 13*4=52
     ui8_t block_dat2[13*S];
 
-    deinterleave(gpx->frame+CONF,  7, hamming_conf);
-    deinterleave(gpx->frame+DAT1, 13, hamming_dat1);
-    deinterleave(gpx->frame+DAT2, 13, hamming_dat2);
-
-    ret0 = hamming(gpx->option.ecc, hamming_conf,  7, block_conf);
-    ret1 = hamming(gpx->option.ecc, hamming_dat1, 13, block_dat1);
-    ret2 = hamming(gpx->option.ecc, hamming_dat2, 13, block_dat2);
+    ret0 = hamming(gpx->option.ecc, gpx->frame+CONF,  7, block_conf);
+    ret1 = hamming(gpx->option.ecc, gpx->frame+DAT1, 13, block_dat1);
+    ret2 = hamming(gpx->option.ecc, gpx->frame+DAT2, 13, block_dat2);
     ret = ret0 | ret1 | ret2;
 
     if (gpx->option.raw == 9) {
@@ -1247,15 +1255,18 @@ int main(int argc, char **argv) {
     int option_dist = 0;     // continuous pcks 0..8
     int option_auto = 0;
     int option_min = 0;
+    int option_jobs = 0;
     int option_iq = 0;
     int option_iqdc = 0;
     int option_lp = 0;
     int option_dc = 0;
     int option_noLUT = 0;
+    int option_noVEC = 0;
     int option_bin = 0;
     int option_softin = 0;
     int option_json = 0;     // JSON blob output (for auto_rx)
     int option_pcmraw = 0;
+    char *shm_name = NULL;
     int wavloaded = 0;
     int sel_wavch = 0;       // audio channel: left
     int spike = 0;
@@ -1316,6 +1327,8 @@ int main(int argc, char **argv) {
             fprintf(stderr, "       --ecc        (Hamming ECC)\n");
             fprintf(stderr, "       --ths <x>    (peak threshold; default=%.1f)\n", thres);
             fprintf(stderr, "       --json       (JSON output)\n");
+            fprintf(stderr, "       --jobs <n>   (replay file in n parallel segments)\n");
+            fprintf(stderr, "       --shm <name> (IQ input: shared memory, iq_shm)\n");
             return 0;
         }
         else if ( (strcmp(*argv, "-v") == 0) || (strcmp(*argv, "--verbose") == 0) ) {
@@ -1400,9 +1413,14 @@ int main(int argc, char **argv) {
         else if   (strcmp(*argv, "--lpFM") == 0) { option_lp |= LP_FM; }  // FM lowpass
         else if   (strcmp(*argv, "--dc") == 0) { option_dc = 1; }
         else if   (strcmp(*argv, "--noLUT") == 0) { option_noLUT = 1; }
+        else if   (strcmp(*argv, "--noVEC") == 0) { option_noVEC = 1; }
         else if   (strcmp(*argv, "--min") == 0) {
             option_min = 1;
         }
+        else if   (strcmp(*argv, "--jobs") == 0) {
+            ++argv;
+            if (*argv) option_jobs = atoi(*argv); else return -1;
+        }
         else if ( (strcmp(*argv, "--br") == 0) ) {
             ++argv;
             if (*argv) {
@@ -1414,6 +1432,11 @@ int main(int argc, char **argv) {
         else if   (strcmp(*argv, "--dbg") == 0) { gpx.option.dbg = 1; }
         else if   (strcmp(*argv, "--sat") == 0) { gpx.option.sat = 1; }
         else if (strcmp(*argv, "--rawhex") == 0) { rawhex = 1; }  // raw hex input
+        else if   (strcmp(*argv, "--shm") == 0) {
+            ++argv;
+            if (*argv) shm_name = *argv; else return -1;
+            option_pcmraw = 1;
+        }
         else if (strcmp(*argv, "-") == 0) {
             int sample_rate = 0, bits_sample = 0, channels = 0;
             ++argv;
@@ -1448,6 +1471,7 @@ int main(int argc, char **argv) {
     // LUT recommonded if decM > 2
     //
     if (option_noLUT && option_iq == 5) dsp.opt_nolut = 1; else dsp.opt_nolut = 0;
+    if (option_noVEC && option_iq == 5) dsp.opt_novec = 1; else dsp.opt_novec = 0;
 
 
     // ecc2-soft_decision accepts also 2-error words,
@@ -1466,6 +1490,7 @@ int main(int argc, char **argv) {
             gencode(msg, code);
             for (k = 0; k < 8; k++) codewords[nib][k] = code[k];
         }
+        init_hamtab();
     }
 
     // init gpx
@@ -1512,7 +1537,15 @@ int main(int argc, char **argv) {
             if (option_iq) sel_wavch = 0;
 
             pcm.sel_ch = sel_wavch;
-            if (option_pcmraw == 0) {
+            if (shm_name) {
+                k = shm_attach(&dsp, &pcm, shm_name);
+                if ( k < 0 ) {
+                    fclose(fp);
+                    fprintf(stderr, "error: shm %s\n", shm_name);
+                    return -1;
+                }
+            }
+            else if (option_pcmraw == 0) {
                 k = read_wav_header(&pcm, fp);
                 if ( k < 0 ) {
                     fclose(fp);
@@ -1563,6 +1596,12 @@ int main(int argc, char **argv) {
                 fprintf(stderr, "sps corr: %.4f\n", dsp.sps);
             }
 
+            if (option_jobs > 1) {
+                k = replay_jobs(&dsp, option_jobs);
+                if (k < 0) { fclose(fp); return -1; }
+                if (k > 0) { fclose(fp); return 0; } // segment outputs merged
+            }
+
             k = init_buffers(&dsp);
             if ( k < 0 ) {
                 fprintf(stderr, "error: init buffers\n");
@@ -0,0 +1,124 @@
+
+/*
+ *  dft_bench: getCorrDFT() transforms, table-driven radix-2^2 vs. old radix-2,
+ *  at the N that init_buffers() uses (8192..32768)
+ *
+ *  compile:
+ *          gcc -Ofast dft_bench.c -lm -o dft_bench
+ *  usage:
+ *          ./dft_bench
+ *
+ *  us per transform (clock()); relerr vs. old complex DFT
+ */
+
+#include <time.h>
+
+#include "demod_mod.c"  // static dft functions
+
+
+// radix-2, j/k bit reversal and w1*=w2 recurrence (before table-driven FFT)
+static void old_dft(dft_t *dft, float complex *Z) {
+    int s, l, l2, i, j, k;
+    float complex  w1, w2, T;
+
+    j = 1;
+    for (i = 1; i < dft->N; i++) {
+        if (i < j) {
+            T = Z[j-1];
+            Z[j-1] = Z[i-1];
+            Z[i-1] = T;
+        }
+        k = dft->N/2;
+        while (k < j) {
+            j = j - k;
+            k = k/2;
+        }
+        j = j + k;
+    }
+
+    for (s = 0; s < dft->LOG2N; s++) {
+        l2 = 1 << s;
+        l  = l2 << 1;
+        w1 = (float complex)1.0;
+        w2 = dft->ew[s]; // cexp(-I*M_PI/(float)l2)
+        for (j = 1; j <= l2; j++) {
+            for (i = j; i <= dft->N; i += l) {
+                k = i + l2;
+                T = Z[k-1] * w1;
+                Z[k-1] = Z[i-1] - T;
+                Z[i-1] = Z[i-1] + T;
+            }
+            w1 = w1 * w2;
+        }
+    }
+}
+
+static double us(clock_t t0, clock_t t1, int rep) {
+    return 1e6*(t1-t0)/CLOCKS_PER_SEC/rep;
+}
+
+int main(int argc, char *argv[]) {
+    int LOG2N, N, i, n, k, rep;
+    dft_t dft;
+    float *x;
+    float complex *A, *B, *C;
+    double e1, e2, e3, nrm, nr3;
+    clock_t t0, t1, t2, t3, t4;
+
+    printf("     N    relerr: r2c      c2r     | us: old     r2c     old^-1  c2r\n");
+
+    for (LOG2N = 10; LOG2N <= 15; LOG2N++) {
+        N = 1 << LOG2N;
+        memset(&dft, 0, sizeof(dft));
+        dft.N = N;
+        dft.LOG2N = LOG2N;
+        dft.ew  = calloc(LOG2N+1, sizeof(float complex));
+        dft.brv = calloc(N, sizeof(int));
+        dft.tw  = calloc(N, sizeof(float complex));
+        x = calloc(N, sizeof(float));
+        A = calloc(N, sizeof(float complex));
+        B = calloc(N, sizeof(float complex));
+        C = calloc(N, sizeof(float complex));
+        if (dft.ew == NULL || dft.brv == NULL || dft.tw == NULL
+           || x == NULL || A == NULL || B == NULL || C == NULL) return -1;
+
+        for (n = 0; n < LOG2N; n++) dft.ew[n] = cexp(-I*M_PI/(float)(1<<n));
+        dft_tables(&dft);
+
+        srand(1);
+        for (i = 0; i < N; i++) x[i] = rand()/(float)RAND_MAX - 0.5;
+
+        // forward: rdft() vs. old complex DFT
+        for (i = 0; i < N; i++) A[i] = x[i];
+        old_dft(&dft, A);
+        rdft(&dft, x, B);
+        e1 = 0; nrm = 0;
+        for (i = 0; i < N; i++) { e1 += cabs(A[i]-B[i]); nrm += cabs(A[i]); }
+
+        // inverse (unnormalized): rNidft() vs. old_dft(conj(Z)), real output
+        for (i = 0; i < N; i++) C[i] = conj(A[i]);
+        old_dft(&dft, C);
+        rNidft(&dft, A, B);
+        e3 = 0; nr3 = 0;
+        for (i = 0; i < N; i++) { e3 += fabs(creal(C[i])-creal(B[i])) + fabs(cimag(B[i])); nr3 += fabs(creal(C[i])); }
+
+        rep = (1<<23)/N;
+        t0 = clock();
+        for (k = 0; k < rep; k++) { for (i = 0; i < N; i++) C[i] = x[i]; old_dft(&dft, C); }
+        t1 = clock();
+        for (k = 0; k < rep; k++) rdft(&dft, x, B);
+        t2 = clock();
+        for (k = 0; k < rep; k++) { for (i = 0; i < N; i++) C[i] = conj(A[i]); old_dft(&dft, C); }
+        t3 = clock();
+        for (k = 0; k < rep; k++) rNidft(&dft, A, B);
+        t4 = clock();
+
+        printf("%6d    %.1e  %.1e  |  %6.1f  %6.1f  %6.1f  %6.1f\n", N, e1/nrm, e3/nr3,
+               us(t0, t1, rep), us(t1, t2, rep), us(t2, t3, rep), us(t3, t4, rep));
+
+        free(dft.ew); free(dft.brv); free(dft.tw);
+        free(x); free(A); free(B); free(C);
+    }
+
+    return 0;
+}
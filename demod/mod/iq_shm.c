@@ -0,0 +1,225 @@
+
+/*
+ *  iq_shm: IQ baseband stream -> POSIX shared memory ring,
+ *  several decoders read the same stream:  --shm <name> --IQ <fq>
+ *
+ *  compile:
+ *          gcc -c demod_mod.c
+ *          gcc iq_shm.c demod_mod.o -lm -o iq_shm
+ *          (glibc < 2.34: -lrt)
+ *  usage:
+ *          ./iq_shm [--size <MB>] [--readers <n>] <name> <iq_baseband.wav>
+ *          rtl_sdr -f 403M -s 1920000 - | ./iq_shm <name> - 1920000 8
+ *          ./rs41mod --shm <name> --IQ <fq>
+ *
+ *  live stream: the writer does not wait, slow readers lose data (overrun);
+ *  --readers <n>: start if n readers attached, then throttle to the slowest reader (e.g. file replay)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "demod_mod.h"
+
+#define SHM_SIZE   64     // MB, default ring size
+#define SHM_CHUNK  (1<<16) // bytes per write
+#define SHM_POLL   2000   // us
+
+static volatile sig_atomic_t stop = 0;
+
+static void sig_stop(int sig) {
+    stop = 1;
+}
+
+static void *shm_map2(int fd, size_t len) {
+    ui8_t *p = mmap(NULL, 2*len, PROT_NONE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) return NULL;
+    if (mmap(p,     len, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_FIXED, fd, SHM_HDRLEN) == MAP_FAILED ||
+        mmap(p+len, len, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_FIXED, fd, SHM_HDRLEN) == MAP_FAILED) {
+        munmap(p, 2*len);
+        return NULL;
+    }
+    return p;
+}
+
+// readers attached; min. position of the blocks in use
+static int shm_readers(shm_hdr_t *h, ui64_t *rmin) {
+    int k, n = 0;
+    ui32_t pid;
+    ui64_t r;
+
+    *rmin = h->wpos;
+    for (k = 0; k < SHM_MAXRD; k++) {
+        pid = __atomic_load_n(&h->rd_pid[k], __ATOMIC_ACQUIRE);
+        if (pid == 0) continue;
+        if (kill(pid, 0) != 0 && errno == ESRCH) {  // reader gone
+            __atomic_compare_exchange_n(&h->rd_pid[k], &pid, 0, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+            continue;
+        }
+        r = __atomic_load_n(&h->rd_pos[k], __ATOMIC_ACQUIRE);
+        if (r < *rmin) *rmin = r;
+        n++;
+    }
+    return n;
+}
+
+int main(int argc, char *argv[]) {
+
+    FILE *fp = NULL;
+    char *fpname;
+    char *name = NULL;
+    char path[256];
+    int option_pcmraw = 0;
+    int readers = 0;
+    int size_MB = SHM_SIZE;
+    int fd, k;
+    size_t size, frm, len, n;
+    size_t r = 0;  // bytes of incomplete frame after wpos
+    ui64_t w, rmin;
+    shm_hdr_t *h;
+    ui8_t *buf;
+    pcm_t pcm = {0};
+    struct sigaction sa;
+
+    fpname = argv[0];
+    ++argv;
+    while (*argv) {
+        if      ( (strcmp(*argv, "-h") == 0) || (strcmp(*argv, "--help") == 0) ) {
+            fprintf(stderr, "%s [options] <name> <iq_baseband.wav>\n", fpname);
+            fprintf(stderr, "%s [options] <name> - <sr> <bs>\n", fpname);
+            fprintf(stderr, "  options:\n");
+            fprintf(stderr, "       --size <MB>    (ring size, default %d)\n", SHM_SIZE);
+            fprintf(stderr, "       --readers <n>  (wait for n readers, throttle to slowest)\n");
+            return 0;
+        }
+        else if (strcmp(*argv, "--size") == 0) {
+            ++argv;
+            if (*argv) size_MB = atoi(*argv); else return -1;
+            if (size_MB < 1) size_MB = 1;
+        }
+        else if (strcmp(*argv, "--readers") == 0) {
+            ++argv;
+            if (*argv) readers = atoi(*argv); else return -1;
+            if (readers > SHM_MAXRD) readers = SHM_MAXRD;
+        }
+        else if (name == NULL) {
+            name = *argv;
+        }
+        else if (strcmp(*argv, "-") == 0) {
+            int sample_rate = 0, bits_sample = 0;
+            ++argv;
+            if (*argv) sample_rate = atoi(*argv); else return -1;
+            ++argv;
+            if (*argv) bits_sample = atoi(*argv); else return -1;
+            if (sample_rate < 1 || (bits_sample != 8 && bits_sample != 16 && bits_sample != 32)) {
+                fprintf(stderr, "- <sr> <bs>\n");
+                return -1;
+            }
+            pcm.sr  = sample_rate;
+            pcm.bps = bits_sample;
+            pcm.nch = 2;
+            option_pcmraw = 1;
+            fp = stdin;
+        }
+        else {
+            fp = fopen(*argv, "rb");
+            if (fp == NULL) {
+                fprintf(stderr, "error: open %s\n", *argv);
+                return -1;
+            }
+        }
+        ++argv;
+    }
+    if (name == NULL) {
+        fprintf(stderr, "error: shm name\n");
+        return -1;
+    }
+    if (fp == NULL) fp = stdin;
+
+    if (option_pcmraw == 0) {
+        k = read_wav_header(&pcm, fp);
+        if ( k < 0 || pcm.nch != 2 ) {
+            fclose(fp);
+            fprintf(stderr, "error: wav header (IQ)\n");
+            return -1;
+        }
+    }
+
+    frm = pcm.nch * (pcm.bps/8);
+    size = (size_t)size_MB << 20;     // page size and IQ sample size 2,4,8: multiple
+    len = SHM_CHUNK;
+
+    snprintf(path, sizeof(path), "%s%s", name[0] == '/' ? "" : "/", name);
+    fd = shm_open(path, O_RDWR|O_CREAT|O_TRUNC, 0644);
+    if (fd < 0) {
+        fprintf(stderr, "error: shm_open %s\n", path);
+        return -1;
+    }
+    if (ftruncate(fd, SHM_HDRLEN + size) != 0) {
+        fprintf(stderr, "error: shm size\n");
+        close(fd); shm_unlink(path);
+        return -1;
+    }
+    h = mmap(NULL, SHM_HDRLEN, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+    buf = shm_map2(fd, size);
+    close(fd);
+    if (h == MAP_FAILED || buf == NULL) {
+        fprintf(stderr, "error: shm mmap\n");
+        shm_unlink(path);
+        return -1;
+    }
+
+    memset(h, 0, SHM_HDRLEN);
+    h->sr  = pcm.sr;
+    h->bps = pcm.bps;
+    h->nch = pcm.nch;
+    h->size = size;
+    h->wr_pid = getpid();
+    __atomic_store_n(&h->magic, SHM_MAGIC, __ATOMIC_RELEASE);
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = sig_stop;  // no SA_RESTART: interrupt fread()
+    sigaction(SIGINT,  &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    fprintf(stderr, "shm: %s  sr: %d  bits: %d  ring: %.1f sec\n", path, pcm.sr, pcm.bps, size/(double)(pcm.sr*frm));
+
+    if (readers > 0) {
+        fprintf(stderr, "shm: wait for %d readers\n", readers);
+        while (!stop && shm_readers(h, &rmin) < readers) usleep(10*SHM_POLL);
+    }
+
+    w = 0;
+    while (!stop) {
+        if (readers > 0) {  // throttle: blocks in use not overwritten
+            while (!stop && shm_readers(h, &rmin) > 0 && w + len - rmin > size) usleep(SHM_POLL);
+        }
+        n = fread(buf + (w+r) % size, 1, len-r, fp);
+        if (n == 0) break;
+        r += n;
+        n = r - r % frm;  // whole IQ samples, rest stays for the next fread
+        r -= n;
+        w += n;
+        __atomic_store_n(&h->wpos, w, __ATOMIC_RELEASE);
+    }
+
+    __atomic_store_n(&h->eof, 1, __ATOMIC_RELEASE);
+    fprintf(stderr, "shm: %.1f sec\n", w/(double)(pcm.sr*frm));
+
+    // readers keep the mapping, name can go
+    shm_unlink(path);
+    munmap(buf, 2*size);
+    munmap(h, SHM_HDRLEN);
+    fclose(fp);
+
+    return 0;
+}
@@ -1145,14 +1145,17 @@ int main(int argc, char **argv) {
 
     //int option_res = 0;      // genauere Bitmessung
     int option_min = 0;
+    int option_jobs = 0;
     int option_iq = 0;
     int option_iqdc = 0;
     int option_lp = 0;
     int option_dc = 0;
     int option_noLUT = 0;
+    int option_noVEC = 0;
     int option_chk = 0;
     int option_softin = 0;
     int option_pcmraw = 0;
+    char *shm_name = NULL;
     int wavloaded = 0;
     int sel_wavch = 0;     // audio channel: left
     int spike = 0;
@@ -1206,6 +1209,8 @@ int main(int argc, char **argv) {
             //fprintf(stderr, "       -v, --verbose\n");
             fprintf(stderr, "       -r, --raw\n");
             fprintf(stderr, "       -c, --color\n");
+            fprintf(stderr, "       --jobs <n>   (replay file in n parallel segments)\n");
+            fprintf(stderr, "       --shm <name> (IQ input: shared memory, iq_shm)\n");
             return 0;
         }
         else if ( (strcmp(*argv, "-v") == 0) || (strcmp(*argv, "--verbose") == 0) ) {
@@ -1275,9 +1280,14 @@ int main(int argc, char **argv) {
         else if   (strcmp(*argv, "--lpFM") == 0) { option_lp |= LP_FM; }  // FM lowpass
         else if   (strcmp(*argv, "--dc") == 0) { option_dc = 1; }
         else if   (strcmp(*argv, "--noLUT") == 0) { option_noLUT = 1; }
+        else if   (strcmp(*argv, "--noVEC") == 0) { option_noVEC = 1; }
         else if   (strcmp(*argv, "--min") == 0) {
             option_min = 1;
         }
+        else if   (strcmp(*argv, "--jobs") == 0) {
+            ++argv;
+            if (*argv) option_jobs = atoi(*argv); else return -1;
+        }
         else if   (strcmp(*argv, "--json") == 0) { gpx.option.jsn = 1; }
         else if   (strcmp(*argv, "--jsn_cfq") == 0) {
             int frq = -1;  // center frequency / Hz
@@ -1287,6 +1297,11 @@ int main(int argc, char **argv) {
             cfreq = frq;
         }
         else if (strcmp(*argv, "--rawhex") == 0) { rawhex = 2; }  // raw hex input
+        else if   (strcmp(*argv, "--shm") == 0) {
+            ++argv;
+            if (*argv) shm_name = *argv; else return -1;
+            option_pcmraw = 1;
+        }
         else if (strcmp(*argv, "-") == 0) {
             int sample_rate = 0, bits_sample = 0, channels = 0;
             ++argv;
@@ -1321,6 +1336,7 @@ int main(int argc, char **argv) {
     // LUT recommonded if decM > 2
     //
     if (option_noLUT && option_iq == 5) dsp.opt_nolut = 1; else dsp.opt_nolut = 0;
+    if (option_noVEC && option_iq == 5) dsp.opt_novec = 1; else dsp.opt_novec = 0;
 
 
     if (gpx.option.raw && gpx.option.jsn) gpx.option.slt = 1;
@@ -1346,7 +1362,15 @@ int main(int argc, char **argv) {
             if (option_iq) sel_wavch = 0;
 
             pcm.sel_ch = sel_wavch;
-            if (option_pcmraw == 0) {
+            if (shm_name) {
+                k = shm_attach(&dsp, &pcm, shm_name);
+                if ( k < 0 ) {
+                    fclose(fp);
+                    fprintf(stderr, "error: shm %s\n", shm_name);
+                    return -1;
+                }
+            }
+            else if (option_pcmraw == 0) {
                 k = read_wav_header(&pcm, fp);
                 if ( k < 0 ) {
                     fclose(fp);
@@ -1394,6 +1418,12 @@ int main(int argc, char **argv) {
             //headerlen = dsp.hdrlen;
 
 
+            if (option_jobs > 1) {
+                k = replay_jobs(&dsp, option_jobs);
+                if (k < 0) { fclose(fp); return -1; }
+                if (k > 0) { fclose(fp); return 0; } // segment outputs merged
+            }
+
             k = init_buffers(&dsp);
             if ( k < 0 ) {
                 fprintf(stderr, "error: init buffers\n");
@@ -977,8 +977,10 @@ int main(int argc, char **argv) {
     int option_lp = 0;
     int option_dc = 0;
     int option_noLUT = 0;
+    int option_noVEC = 0;
     int option_softin = 0;
     int option_pcmraw = 0;
+    char *shm_name = NULL;
     int wavloaded = 0;
     int sel_wavch = 0;     // audio channel: left
     int spike = 0;
@@ -1034,6 +1036,7 @@ int main(int argc, char **argv) {
             //fprintf(stderr, "       -v, --verbose\n");
             fprintf(stderr, "       -r, --raw\n");
             fprintf(stderr, "       -c, --color\n");
+            fprintf(stderr, "       --shm <name> (IQ input: shared memory, iq_shm)\n");
             return 0;
         }
         else if ( (strcmp(*argv, "-v") == 0) || (strcmp(*argv, "--verbose") == 0) ) {
@@ -1110,6 +1113,7 @@ int main(int argc, char **argv) {
         else if   (strcmp(*argv, "--lpFM") == 0) { option_lp |= LP_FM; }  // FM lowpass
         else if   (strcmp(*argv, "--dc") == 0) { option_dc = 1; }
         else if   (strcmp(*argv, "--noLUT") == 0) { option_noLUT = 1; }
+        else if   (strcmp(*argv, "--noVEC") == 0) { option_noVEC = 1; }
         else if   (strcmp(*argv, "--min") == 0) {
             option_min = 1;
         }
@@ -1122,6 +1126,11 @@ int main(int argc, char **argv) {
             cfreq = frq;
         }
         else if (strcmp(*argv, "--rawhex") == 0) { rawhex = 2; }  // raw hex input
+        else if   (strcmp(*argv, "--shm") == 0) {
+            ++argv;
+            if (*argv) shm_name = *argv; else return -1;
+            option_pcmraw = 1;
+        }
         else if (strcmp(*argv, "-") == 0) {
             int sample_rate = 0, bits_sample = 0, channels = 0;
             ++argv;
@@ -1156,6 +1165,7 @@ int main(int argc, char **argv) {
     // LUT recommonded if decM > 2
     //
     if (option_noLUT && option_iq == 5) dsp.opt_nolut = 1; else dsp.opt_nolut = 0;
+    if (option_noVEC && option_iq == 5) dsp.opt_novec = 1; else dsp.opt_novec = 0;
 
 
     if (gpx.option.raw && gpx.option.jsn) gpx.option.slt = 1;
@@ -1181,7 +1191,15 @@ int main(int argc, char **argv) {
             if (option_iq) sel_wavch = 0;
 
             pcm.sel_ch = sel_wavch;
-            if (option_pcmraw == 0) {
+            if (shm_name) {
+                k = shm_attach(&dsp, &pcm, shm_name);
+                if ( k < 0 ) {
+                    fclose(fp);
+                    fprintf(stderr, "error: shm %s\n", shm_name);
+                    return -1;
+                }
+            }
+            else if (option_pcmraw == 0) {
                 k = read_wav_header(&pcm, fp);
                 if ( k < 0 ) {
                     fclose(fp);
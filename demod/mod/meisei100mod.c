@@ -292,8 +292,10 @@ int main(int argc, char **argv) {
     int option_lp = 0;
     int option_dc = 0;
     int option_noLUT = 0;
+    int option_noVEC = 0;
     int option_softin = 0;
     int option_pcmraw = 0;
+    char *shm_name = NULL;
     int sel_wavch = 0;
     int wavloaded = 0;
     int cfreq = -1;
@@ -375,6 +377,7 @@ int main(int argc, char **argv) {
             fprintf(stderr, "  options:\n");
             //fprintf(stderr, "       -v, --verbose\n");
             fprintf(stderr, "       -r, --raw\n");
+            fprintf(stderr, "       --shm <name> (IQ input: shared memory, iq_shm)\n");
             return 0;
         }
         else if ( (strcmp(*argv, "-r") == 0) ) { option_raw = 1; }
@@ -444,6 +447,7 @@ int main(int argc, char **argv) {
         else if   (strcmp(*argv, "--lpFM") == 0) { option_lp |= LP_FM; }  // FM lowpass
         else if   (strcmp(*argv, "--dc") == 0) { option_dc = 1; }
         else if   (strcmp(*argv, "--noLUT") == 0) { option_noLUT = 1; }
+        else if   (strcmp(*argv, "--noVEC") == 0) { option_noVEC = 1; }
         else if   (strcmp(*argv, "--min") == 0) {
             option_min = 1;
         }
@@ -458,6 +462,11 @@ int main(int argc, char **argv) {
             if (frq < 300000000) frq = -1;
             cfreq = frq;
         }
+        else if   (strcmp(*argv, "--shm") == 0) {
+            ++argv;
+            if (*argv) shm_name = *argv; else return -1;
+            option_pcmraw = 1;
+        }
         else if (strcmp(*argv, "-") == 0) {
             int sample_rate = 0, bits_sample = 0, channels = 0;
             ++argv;
@@ -494,6 +503,7 @@ int main(int argc, char **argv) {
     // LUT recommonded if decM > 2
     //
     if (option_noLUT && option_iq == 5) dsp.opt_nolut = 1; else dsp.opt_nolut = 0;
+    if (option_noVEC && option_iq == 5) dsp.opt_novec = 1; else dsp.opt_novec = 0;
 
     if (cfreq > 0) gpx.jsn_freq = (cfreq+500)/1000;
 
@@ -515,7 +525,15 @@ int main(int argc, char **argv) {
         if (option_iq) sel_wavch = 0;
 
         pcm.sel_ch = sel_wavch;
-        if (option_pcmraw == 0) {
+        if (shm_name) {
+            k = shm_attach(&dsp, &pcm, shm_name);
+            if ( k < 0 ) {
+                fclose(fp);
+                fprintf(stderr, "error: shm %s\n", shm_name);
+                return -1;
+            }
+        }
+        else if (option_pcmraw == 0) {
             k = read_wav_header(&pcm, fp);
             if ( k < 0 ) {
                 fclose(fp);
@@ -1795,6 +1795,83 @@ int NAV_LinP(int N, SAT_t satv[], double pos_ecef[3], double dt,
     return 0;
 }
 
+// gewichtete Linearisierung (WLS/Gauss-Newton-Schritt), res: Residuen nach dem Schritt
+int NAV_LinP_W(int N, SAT_t satv[], double w[], double pos_ecef[3], double dt,
+                      double dpos_ecef[3], double *cc, double res[]) {
+
+    int i, j, k;
+    double B[N][4], Binv[4][N], BtB[4][4], BBinv[4][4];
+    double a[N], Ba[4];
+
+    double X, Y, Z;
+    double norm;
+    double range, obs_range, prox_range;
+
+    if (N < 4 || N > 12) return -1;
+
+    for (i = 0; i < N; i++) {
+
+        range = dist( pos_ecef[0], pos_ecef[1], pos_ecef[2], satv[i].X, satv[i].Y, satv[i].Z );
+        range /= LIGHTSPEED;
+        if (range < 0.06  ||  range > 0.1) range = RANGE_ESTIMATE;
+        rotZ(satv[i].X, satv[i].Y, satv[i].Z, EARTH_ROTATION_RATE*range, B[i], B[i]+1, B[i]+2);
+
+        X = B[i][0]-pos_ecef[0];
+        Y = B[i][1]-pos_ecef[1];
+        Z = B[i][2]-pos_ecef[2];
+        norm = sqrt(X*X+Y*Y+Z*Z);
+
+        B[i][0] = X/norm;
+        B[i][1] = Y/norm;
+        B[i][2] = Z/norm;
+
+        B[i][3] = 1;
+
+        obs_range = satv[i].pseudorange + satv[i].clock_corr;
+        prox_range = norm - dt;
+        a[i] = prox_range - obs_range;
+    }
+
+    for (i = 0; i < 4; i++) {
+        for (j = 0; j < 4; j++) {
+            BtB[i][j] = 0.0;
+            for (k = 0; k < N; k++) {
+                BtB[i][j] += B[k][i]*w[k]*B[k][j];
+            }
+        }
+    }
+    if (matrix_invert(BtB, BBinv) != 0) return -1;
+    for (i = 0; i < 4; i++) {
+        for (j = 0; j < N; j++) {
+            Binv[i][j] = 0.0;
+            for (k = 0; k < 4; k++) {
+                Binv[i][j] += BBinv[i][k]*B[j][k];
+            }
+            Binv[i][j] *= w[j];
+        }
+    }
+
+    for (i = 0; i < 4; i++) {
+        Ba[i] = 0.0;
+        for (k = 0; k < N; k++) {
+            Ba[i] += Binv[i][k]*a[k];
+        }
+    }
+
+    for (i = 0; i < N; i++) {
+        res[i] = a[i];
+        for (k = 0; k < 4; k++) res[i] -= B[i][k]*Ba[k];
+    }
+
+    dpos_ecef[0] = Ba[0];
+    dpos_ecef[1] = Ba[1];
+    dpos_ecef[2] = Ba[2];
+
+    *cc = Ba[3];
+
+    return 0;
+}
+
 int NAV_LinV(int N, SAT_t satv[], double pos_ecef[3],
                     double vel_ecef[3], double dt,
                     double dvel_ecef[3], double *cc) {
@@ -65,6 +65,7 @@ typedef struct {
     i8_t aut;
     i8_t jsn;  // JSON output (auto_rx)
     i8_t slt;  // silent (only raw/json)
+    int  ecn;  // ecc3: max. RS trials per frame
 } option_t;
 
 typedef struct {
@@ -1493,16 +1494,203 @@ static int inFixed(gpx_t *gpx, int idx, int *frmset, int setcnt) {
 #define rs_R 24
 #define rs_K (rs_N-rs_R)
 
+/* ------------------------------------------------------------------------------------ */
+/*
+ *  Chase/GMD (ecc3,ecc4):
+ *    Bytes nach Zuverlaessigkeit (min |softbit|) sortiert;
+ *    (Chase) low-score bit der GMD_P unzuverlaessigsten Bytes togglen,
+ *            Muster nach Summe der Scores sortiert,
+ *    (GMD)   danach die e = 1..2t unzuverlaessigsten Bytes als Erasures;
+ *    RS-Ergebnisse sind nur Kandidaten, gueltig erst mit CRC aller Bloecke;
+ *    max. gpx->option.ecn Dekodierversuche pro Frame
+ */
+
+#define GMD_P    10   // Chase: 2^GMD_P toggle patterns
+#define GMD_NPOS (GMD_P > rs_R ? GMD_P : rs_R)
+#define GMD_CAND 16   // distinct candidates per codeword
+
+typedef struct {
+    float score;
+    int idx;
+} score_t;
+
+static int cmp_score(const void *a, const void *b) {
+    const score_t *sa = a, *sb = b;
+    if (sa->score < sb->score) return -1;
+    if (sa->score > sb->score) return  1;
+    return sa->idx - sb->idx;
+}
+
+typedef struct {
+    ui8_t cw[rs_N];               // received codeword
+    ui8_t pos[GMD_NPOS];          // cw positions, increasing reliability
+    ui8_t tgl[GMD_NPOS];          // low-score bit
+    float score[GMD_NPOS];
+    int npos;
+    score_t pat[1<<GMD_P];        // toggle patterns, increasing score sum
+    int t;                        // next trial
+    ui8_t cand[GMD_CAND][rs_N];
+    int nerr[GMD_CAND];
+    int ncand;
+} gmd_t;
+
+static int frmpos2cw(int pos_frm, int subcw) {
+    int pos_cw;
+    if (pos_frm < cfg_rs41.msgpos) {
+        pos_cw = pos_frm - cfg_rs41.parpos;
+        if (subcw == 2) pos_cw -= rs_R;
+        if (pos_cw < 0 || pos_cw >= rs_R) return -1;
+    }
+    else {
+        if ((pos_frm - cfg_rs41.msgpos) % 2 != subcw-1) return -1;
+        pos_cw = rs_R + (pos_frm - cfg_rs41.msgpos)/2;
+        if (pos_cw > 254) return -1;
+    }
+    return pos_cw;
+}
+
+static void cw2frm(gpx_t *gpx, ui8_t *cw, int subcw) {
+    int i;
+    int ofs = subcw-1;
+    for (i = 0; i < rs_R; i++) gpx->frame[cfg_rs41.parpos+ofs*rs_R+i] = cw[i];
+    for (i = 0; i < rs_K && cfg_rs41.msgpos+ofs+2*i < FRAME_LEN; i++) gpx->frame[cfg_rs41.msgpos+ofs+2*i] = cw[rs_R+i];
+}
+
+static int frm_crcOK(gpx_t *gpx, int frmlen) {
+    int pos = pos_FRAME;
+    int blk = 0;
+    while (pos < frmlen-1) {
+        if (check_CRC(gpx, pos, gpx->frame[pos]<<8) != 0) return 0;
+        pos += gpx->frame[pos+1] + 4;
+        blk++;
+    }
+    return (blk > 0);
+}
+
+static void gmd_init(gpx_t *gpx, gmd_t *g, ui8_t *cw, int *sort_idx, int subcw, int *frmset, int setcnt) {
+    int j, b, pos_frm, pos_cw;
+
+    memcpy(g->cw, cw, rs_N);
+    g->npos = 0;
+    for (j = 0; j < FRAME_LEN && g->npos < GMD_NPOS; j++) {
+        pos_frm = sort_idx[j];
+        if (inFixed(gpx, pos_frm, frmset, setcnt)) continue;
+        pos_cw = frmpos2cw(pos_frm, subcw);
+        if (pos_cw < 0) continue;
+        g->pos[g->npos] = pos_cw;
+        g->tgl[g->npos] = gpx->dfrm_bitscore[pos_frm];
+        g->score[g->npos] = fabs(gpx->ecdat.frm_bytescore[pos_frm]);
+        g->npos++;
+    }
+    for (j = 0; j < (1<<GMD_P); j++) {
+        g->pat[j].score = 0.0f;
+        g->pat[j].idx = j;
+        for (b = 0; b < GMD_P && b < g->npos; b++) {
+            if ((j>>b) & 1) g->pat[j].score += g->score[b];
+        }
+    }
+    qsort(g->pat, 1<<GMD_P, sizeof(g->pat[0]), cmp_score);
+    g->t = 1; // pat[0]=0: 1st/2nd pass
+    g->ncand = 0;
+}
+
+// 1: new candidate, 0: no (new) candidate, -1: done
+static int gmd_next(gpx_t *gpx, gmd_t *g) {
+    ui8_t cw[rs_N];
+    ui8_t era_pos[rs_R];
+    ui8_t err_pos[rs_R], err_val[rs_R];
+    int i, b, m, nera = 0, errors;
+    int t = g->t;
+
+    if (t >= (1<<GMD_P)+rs_R || g->ncand >= GMD_CAND) return -1;
+    g->t++;
+
+    memcpy(cw, g->cw, rs_N);
+    if (t < (1<<GMD_P)) { // Chase
+        m = g->pat[t].idx;
+        for (b = 0; b < GMD_P && b < g->npos; b++) {
+            if ((m>>b) & 1) cw[g->pos[b]] ^= g->tgl[b];
+        }
+    }
+    else { // GMD
+        nera = t - (1<<GMD_P) + 1;
+        if (nera > g->npos) nera = g->npos;
+        for (i = 0; i < nera; i++) era_pos[i] = g->pos[i];
+    }
+
+    errors = rs_decode_ErrEra(&gpx->RS, cw, nera, era_pos, err_pos, err_val);
+    if (errors < 0) return 0;
+
+    for (i = 0; i < g->ncand; i++) {
+        if (memcmp(g->cand[i], cw, rs_N) == 0) return 0;
+    }
+    memcpy(g->cand[g->ncand], cw, rs_N);
+    g->nerr[g->ncand] = errors;
+    g->ncand++;
+    return 1;
+}
+
+// ecc3-pass: errors1/errors2 < 0 -> trials until CRC-OK
+static int gmd_frame(gpx_t *gpx, int frmlen, ui8_t *cw1, ui8_t *cw2, int *errors1, int *errors2,
+                     int *frmset, int setcnt) {
+    gmd_t g[2];
+    gmd_t *g1 = g, *g2 = g+1;
+    int trials = gpx->option.ecn;
+    int fin1 = 0, fin2 = 0;
+    int i, r;
+
+    if (*errors1 < 0) gmd_init(gpx, g1, cw1, gpx->ecdat.sort_idx1, 1, frmset, setcnt);
+    else { memcpy(g1->cand[0], cw1, rs_N); g1->nerr[0] = *errors1; g1->ncand = 1; fin1 = 1; }
+    if (*errors2 < 0) gmd_init(gpx, g2, cw2, gpx->ecdat.sort_idx2, 2, frmset, setcnt);
+    else { memcpy(g2->cand[0], cw2, rs_N); g2->nerr[0] = *errors2; g2->ncand = 1; fin2 = 1; }
+
+    while (trials > 0 && !(fin1 && fin2)) {
+        if (!fin1) { // new cw1 candidate vs. all cw2 candidates
+            r = gmd_next(gpx, g1); trials--;
+            if (r < 0) fin1 = 1;
+            if (r > 0) {
+                cw2frm(gpx, g1->cand[g1->ncand-1], 1);
+                for (i = 0; i < g2->ncand; i++) {
+                    cw2frm(gpx, g2->cand[i], 2);
+                    if (frm_crcOK(gpx, frmlen)) {
+                        memcpy(cw1, g1->cand[g1->ncand-1], rs_N); *errors1 = g1->nerr[g1->ncand-1];
+                        memcpy(cw2, g2->cand[i], rs_N);           *errors2 = g2->nerr[i];
+                        return 0;
+                    }
+                }
+            }
+        }
+        if (!fin2 && trials > 0) {
+            r = gmd_next(gpx, g2); trials--;
+            if (r < 0) fin2 = 1;
+            if (r > 0) {
+                cw2frm(gpx, g2->cand[g2->ncand-1], 2);
+                for (i = 0; i < g1->ncand; i++) {
+                    cw2frm(gpx, g1->cand[i], 1);
+                    if (frm_crcOK(gpx, frmlen)) {
+                        memcpy(cw1, g1->cand[i], rs_N);           *errors1 = g1->nerr[i];
+                        memcpy(cw2, g2->cand[g2->ncand-1], rs_N); *errors2 = g2->nerr[g2->ncand-1];
+                        return 0;
+                    }
+                }
+            }
+        }
+    }
+
+    return -1;
+}
+
 static int rs41_ecc(gpx_t *gpx, int frmlen) {
 // richtige framelen wichtig fuer 0-padding
 
-    int i, j, k, leak, ret = 0;
+    int i, leak, ret = 0;
     int errors1, errors2;
     ui8_t cw1[rs_N], cw2[rs_N];
-    ui8_t err_pos1[rs_R], err_pos2[rs_R],
-          err_val1[rs_R], err_val2[rs_R];
-    ui8_t era_pos[rs_R];
-    ui8_t Era_max = 12; // iteration depth 2..255 (2 erasures for 1 error)
+    ui8_t err_pos[2*rs_R], err_val[2*rs_R];
+    ui8_t *err_pos1 = err_pos, *err_pos2 = err_pos+rs_R,
+          *err_val1 = err_val, *err_val2 = err_val+rs_R;
+    ui8_t *cw[2] = { cw1, cw2 };
+    int errs[2];
 
     int frmset[FRAME_LEN];
     int setcnt = 0;
@@ -1524,8 +1712,9 @@ static int rs41_ecc(gpx_t *gpx, int frmlen) {
     for (i = 0; i < rs_K; i++) cw1[rs_R+i] = gpx->frame[cfg_rs41.msgpos+2*i  ];
     for (i = 0; i < rs_K; i++) cw2[rs_R+i] = gpx->frame[cfg_rs41.msgpos+2*i+1];
 
-    errors1 = rs_decode(&gpx->RS, cw1, err_pos1, err_val1);
-    errors2 = rs_decode(&gpx->RS, cw2, err_pos2, err_val2);
+    rs_decode_batch(&gpx->RS, 2, cw, errs, err_pos, err_val);
+    errors1 = errs[0];
+    errors2 = errs[1];
 
 
     if (gpx->option.ecc >= 2 && (errors1 < 0 || errors2 < 0))
@@ -1550,8 +1739,9 @@ static int rs41_ecc(gpx_t *gpx, int frmlen) {
         }
         for (i = 0; i < rs_K; i++) cw1[rs_R+i] = gpx->frame[cfg_rs41.msgpos+2*i  ];
         for (i = 0; i < rs_K; i++) cw2[rs_R+i] = gpx->frame[cfg_rs41.msgpos+2*i+1];
-        errors1 = rs_decode(&gpx->RS, cw1, err_pos1, err_val1);
-        errors2 = rs_decode(&gpx->RS, cw2, err_pos2, err_val2);
+        rs_decode_batch(&gpx->RS, 2, cw, errs, err_pos, err_val);
+        errors1 = errs[0];
+        errors2 = errs[1];
     }
 
     if (gpx->option.ecc == 4)  // set (probably) known bytes (if same rs41)
@@ -1644,92 +1834,13 @@ static int rs41_ecc(gpx_t *gpx, int frmlen) {
     //   burst errors could affect neighboring bytes, however
     //   if AWGN and 24 bit-errors per frame, probability for 2 bit-errors in 1 byte is low;
     //   low byte-score -> erasure , low bit-score -> bit-toggle:
-    //   - erasures: 11 + 2/2 = 12 (11 errors and 2 erasures per codeword can be corrected)
-    //               11 + 2 = 13: try combinations of 2 erasures with low byte-scores
-    //   - toggle low-score bits
+    //   - Chase: toggle low-score bits of the least reliable bytes
+    //   - GMD: e erasures + (24-e)/2 errors, e = 1..24 least reliable bytes
+    //   list of RS-candidates per codeword, accept first pair with CRC-OK
 
-    if (gpx->option.ecc > 2)
+    if (gpx->option.ecc > 2 && (errors1 < 0 || errors2 < 0))
     {
-        int pos_cw = 0;
-        int pos_frm = 0;
-
-        if (errors1 < 0)
-        {
-            for (i = 1; i < Era_max; i++) {
-                pos_frm = gpx->ecdat.sort_idx1[i];
-                if (inFixed(gpx, pos_frm, frmset, setcnt)) continue;
-                if (pos_frm < cfg_rs41.msgpos) pos_cw = pos_frm - cfg_rs41.parpos;
-                else                           pos_cw = rs_R + (pos_frm - cfg_rs41.msgpos)/2;
-                if (pos_cw < 0 || pos_cw > 254) continue;
-                era_pos[0] = pos_cw;
-                for (j = 0; j < i; j++) {
-                    pos_frm = gpx->ecdat.sort_idx1[j];
-                    if (inFixed(gpx, pos_frm, frmset, setcnt)) continue;
-                    if (pos_frm < cfg_rs41.msgpos) pos_cw = pos_frm - cfg_rs41.parpos;
-                    else                           pos_cw = rs_R + (pos_frm - cfg_rs41.msgpos)/2;
-                    if (pos_cw < 0 || pos_cw > 254) continue;
-                    era_pos[1] = pos_cw;
-
-                    //k = -1;
-                    for (k = -1; k < j; k++)  // toggle low-score bits
-                    {
-                        if (k >= 0) {
-                            pos_frm = gpx->ecdat.sort_idx1[k];
-                            if (inFixed(gpx, pos_frm, frmset, setcnt)) continue;
-                            else {
-                                if (pos_frm < cfg_rs41.msgpos) pos_cw = pos_frm - cfg_rs41.parpos;
-                                else                           pos_cw = rs_R + (pos_frm - cfg_rs41.msgpos)/2;
-                                if (pos_cw < 0 || pos_cw > 254) continue;
-                                cw1[pos_cw] ^= gpx->dfrm_bitscore[pos_frm];
-                            }
-                        }
-
-                        errors1 = rs_decode_ErrEra(&gpx->RS, cw1, 2, era_pos, err_pos1, err_val1);
-                        if (errors1 >= 0) { j = 256; i = 256; k = 256; } //break;
-                        //else if (k >= 0) { cw1[pos_cw] ^= gpx->dfrm_bitscore[pos_frm]; }
-                    }
-                }
-            }
-        }
-
-        if (errors2 < 0)
-        {
-            for (i = 1; i < Era_max; i++) {
-                pos_frm = gpx->ecdat.sort_idx2[i];
-                if (inFixed(gpx, pos_frm, frmset, setcnt)) continue;
-                if (pos_frm < cfg_rs41.msgpos) pos_cw = pos_frm - cfg_rs41.parpos - rs_R;
-                else                           pos_cw = rs_R + (pos_frm - cfg_rs41.msgpos)/2;
-                if (pos_cw < 0 || pos_cw > 254) continue;
-                era_pos[0] = pos_cw;
-                for (j = 0; j < i; j++) {
-                    pos_frm = gpx->ecdat.sort_idx2[j];
-                    if (inFixed(gpx, pos_frm, frmset, setcnt)) continue;
-                    if (pos_frm < cfg_rs41.msgpos) pos_cw = pos_frm - cfg_rs41.parpos - rs_R;
-                    else                           pos_cw = rs_R + (pos_frm - cfg_rs41.msgpos)/2;
-                    if (pos_cw < 0 || pos_cw > 254) continue;
-                    era_pos[1] = pos_cw;
-
-                    //k = -1;
-                    for (k = -1; k < j; k++)  // toggle low-score bits
-                    {
-                        if (k >= 0) {
-                            pos_frm = gpx->ecdat.sort_idx2[k];
-                            if (inFixed(gpx, pos_frm, frmset, setcnt)) continue;
-                            else {
-                                if (pos_frm < cfg_rs41.msgpos) pos_cw = pos_frm - cfg_rs41.parpos - rs_R;
-                                else                           pos_cw = rs_R + (pos_frm - cfg_rs41.msgpos)/2;
-                                if (pos_cw < 0 || pos_cw > 254) continue;
-                                cw2[pos_cw] ^= gpx->dfrm_bitscore[pos_frm];
-                            }
-                        }
-
-                        errors2 = rs_decode_ErrEra(&gpx->RS, cw2, 2, era_pos, err_pos2, err_val2);
-                        if (errors2 >= 0) { j = 256; i = 256; k = 256; } //break;
-                        //else if (k >= 0) { cw2[pos_cw] ^= gpx->dfrm_bitscore[pos_frm]; }
-                    }
-                }
-            }
-        }
+        gmd_frame(gpx, frmlen, cw1, cw2, &errors1, &errors2, frmset, setcnt);
     }
 
 
@@ -2182,10 +2293,11 @@ static int print_position(gpx_t *gpx, int ec) {
 }
 
 static void print_frame(gpx_t *gpx, int len) {
-    int i, j, ec = 0, ft;
+    int i, ec = 0, ft;
     int j1 = 0;
     int j2 = 0;
     int sort_score_idx[FRAME_LEN];
+    score_t sort_score[FRAME_LEN];
     float max_minscore = 0.0;
 
     gpx->crc = 0;
@@ -2212,15 +2324,13 @@ static void print_frame(gpx_t *gpx, int len) {
     }
     for (i = 0; i < FRAME_LEN; i++) sort_score_idx[i] = i;
     if (gpx->option.ecc > 2) {
+        // stable sort by |score| (qsort: ties by index)
         for (i = 0; i < FRAME_LEN; i++) {
-            for (j = 0; j < FRAME_LEN-1; j++) {
-                if (fabs(gpx->ecdat.frm_bytescore[sort_score_idx[j+1]]) < fabs(gpx->ecdat.frm_bytescore[sort_score_idx[j]])) {
-                    int tmp = sort_score_idx[j+1];
-                    sort_score_idx[j+1] = sort_score_idx[j];
-                    sort_score_idx[j] = tmp;
-                }
-            }
+            sort_score[i].score = fabs(gpx->ecdat.frm_bytescore[i]);
+            sort_score[i].idx = i;
         }
+        qsort(sort_score, FRAME_LEN, sizeof(sort_score[0]), cmp_score);
+        for (i = 0; i < FRAME_LEN; i++) sort_score_idx[i] = sort_score[i].idx;
         for (i = 0; i < FRAME_LEN; i++) gpx->ecdat.sort_idx1[i] = i;
         for (i = 0; i < FRAME_LEN; i++) gpx->ecdat.sort_idx2[i] = i;
         j1 = 0;
@@ -2271,14 +2381,17 @@ int main(int argc, char *argv[]) {
 
     //int option_inv = 0;    // invertiert Signal
     int option_min = 0;
+    int option_jobs = 0;
     int option_iq = 0;
     int option_iqdc = 0;
     int option_lp = 0;
     int option_dc = 0;
     int option_noLUT = 0;
+    int option_noVEC = 0;
     int option_bin = 0;
     int option_softin = 0;
     int option_pcmraw = 0;
+    char *shm_name = NULL;
     int wavloaded = 0;
     int sel_wavch = 0;     // audio channel: left
     int rawhex = 0, xorhex = 0;
@@ -2335,8 +2448,12 @@ int main(int argc, char *argv[]) {
             fprintf(stderr, "       -i, --invert\n");
             //fprintf(stderr, "       --crc        (check CRC)\n");
             //fprintf(stderr, "       --ecc2       (Reed-Solomon )\n");
+            fprintf(stderr, "       --ecc3,4     (soft-decision Chase/GMD list decoding)\n");
+            fprintf(stderr, "       --ecn <n>    (ecc3,4: max. RS trials per frame; default=32)\n");
             fprintf(stderr, "       --ths <x>    (peak threshold; default=%.1f)\n", thres);
             fprintf(stderr, "       --iq0,2,3    (IQ data)\n");
+            fprintf(stderr, "       --jobs <n>   (replay file in n parallel segments)\n");
+            fprintf(stderr, "       --shm <name> (IQ input: shared memory, iq_shm)\n");
             return 0;
         }
         else if ( (strcmp(*argv, "-v") == 0) || (strcmp(*argv, "--verbose") == 0) ) {
@@ -2357,6 +2474,11 @@ int main(int argc, char *argv[]) {
         else if   (strcmp(*argv, "--ecc2") == 0) { gpx.option.ecc = 2; }
         else if   (strcmp(*argv, "--ecc3") == 0) { gpx.option.ecc = 3; }
         else if   (strcmp(*argv, "--ecc4") == 0) { gpx.option.ecc = 4; }
+        else if   (strcmp(*argv, "--ecn") == 0) {
+            ++argv;
+            if (*argv) gpx.option.ecn = atoi(*argv);
+            else return -1;
+        }
         else if   (strcmp(*argv, "--sat") == 0) { gpx.option.sat = 1; }
         else if   (strcmp(*argv, "--ptu" ) == 0) { gpx.option.ptu = 1; }
         else if   (strcmp(*argv, "--ptu2") == 0) { gpx.option.ptu = 2; }
@@ -2408,9 +2530,14 @@ int main(int argc, char *argv[]) {
         else if   (strcmp(*argv, "--lpFM") == 0) { option_lp |= LP_FM; }  // FM lowpass
         else if   (strcmp(*argv, "--dc") == 0) { option_dc = 1; }
         else if   (strcmp(*argv, "--noLUT") == 0) { option_noLUT = 1; }
+        else if   (strcmp(*argv, "--noVEC") == 0) { option_noVEC = 1; }
         else if   (strcmp(*argv, "--min") == 0) {
             option_min = 1;
         }
+        else if   (strcmp(*argv, "--jobs") == 0) {
+            ++argv;
+            if (*argv) option_jobs = atoi(*argv); else return -1;
+        }
         else if   (strcmp(*argv, "--json") == 0) {
             gpx.option.jsn = 1;
             gpx.option.ecc = 2;
@@ -2425,6 +2552,11 @@ int main(int argc, char *argv[]) {
         }
         else if   (strcmp(*argv, "--rawhex") == 0) { rawhex = 2; }  // raw hex input
         else if   (strcmp(*argv, "--xorhex") == 0) { rawhex = 2; xorhex = 1; }  // raw xor input
+        else if   (strcmp(*argv, "--shm") == 0) {
+            ++argv;
+            if (*argv) shm_name = *argv; else return -1;
+            option_pcmraw = 1;
+        }
         else if (strcmp(*argv, "-") == 0) {
             int sample_rate = 0, bits_sample = 0, channels = 0;
             ++argv;
@@ -2459,11 +2591,13 @@ int main(int argc, char *argv[]) {
     // LUT recommonded if decM > 2
     //
     if (option_noLUT && option_iq == 5) dsp.opt_nolut = 1; else dsp.opt_nolut = 0;
+    if (option_noVEC && option_iq == 5) dsp.opt_novec = 1; else dsp.opt_novec = 0;
 
 
     if (gpx.option.raw && gpx.option.jsn) gpx.option.slt = 1;
 
     if (gpx.option.ecc < 2) gpx.option.ecc = 1;  // turn off for ber-measurement
+    if (gpx.option.ecn <= 0) gpx.option.ecn = 32;  // ecc3: max. RS trials per frame
 
     if (gpx.option.ecc) {
         rs_init_RS255(&gpx.RS);  // RS, GF
@@ -2496,7 +2630,15 @@ int main(int argc, char *argv[]) {
             if (option_iq) sel_wavch = 0;
 
             pcm.sel_ch = sel_wavch;
-            if (option_pcmraw == 0) {
+            if (shm_name) {
+                k = shm_attach(&dsp, &pcm, shm_name);
+                if ( k < 0 ) {
+                    fclose(fp);
+                    fprintf(stderr, "error: shm %s\n", shm_name);
+                    return -1;
+                }
+            }
+            else if (option_pcmraw == 0) {
                 k = read_wav_header(&pcm, fp);
                 if ( k < 0 ) {
                     fclose(fp);
@@ -2536,12 +2678,19 @@ int main(int argc, char *argv[]) {
             dsp.lpFM_bw = 6e3; // FM audio lowpass
             dsp.opt_dc = option_dc;
             dsp.opt_IFmin = option_min;
+            dsp.opt_blk = 1;
 
             if ( dsp.sps < 8 ) {
                 fprintf(stderr, "note: sample rate low (%.1f sps)\n", dsp.sps);
             }
 
 
+            if (option_jobs > 1) {
+                k = replay_jobs(&dsp, option_jobs);
+                if (k < 0) { fclose(fp); return -1; }
+                if (k > 0) { fclose(fp); return 0; } // segment outputs merged
+            }
+
             k = init_buffers(&dsp); // BT=0.5  (IQ-Int: BT > 0.5 ?)
             if ( k < 0 ) {
                 fprintf(stderr, "error: init buffers\n");
@@ -96,6 +96,17 @@ static ui8_t rs92_header_bytes[6] = { 0x2A, 0x2A, 0x2A, 0x2A, 0x2A, 0x10};
 
 #include "nav_gps_vel.c"
 
+#define SATC_DT 60.0  // sec
+
+typedef struct {
+    EPHEM_t *eph;   // Stuetzstellen t0, t0+SATC_DT
+    int week;
+    double t0;
+    double X[2]; double Y[2]; double Z[2];
+    double vX[2]; double vY[2]; double vZ[2];
+    double cc[2]; double cd[2];
+} SATC_t;
+
 typedef struct {
     i8_t opt_vergps;
     i8_t opt_iter;
@@ -112,8 +123,16 @@ typedef struct {
     ui8_t prn32next;
     EPHEM_t alm[33];
     EPHEM_t *ephs;
+    int *ephidx;      // ephs je PRN: ephidx[ephofs[prn]..ephofs[prn+1]-1]
+    int ephofs[34];
     SAT_t sat[33];
     SAT_t sat1s[33];
+    SATC_t satc[33];
+    SATC_t satc1s[33];
+    float raim;  // WLS: max. sigma/m
+    int fix;     // WLS: letzte Position
+    double pos_ecef[3];
+    double cc;
 } GPS_t;
 
 typedef struct {
@@ -842,11 +861,60 @@ static void prn12(GPS_t *gps, ui8_t *prn_le, ui8_t prns[12]) {
     }
 }
 
-static int calc_satpos_alm(gpx_t *gpx, double t, SAT_t *satp) {
-    double X, Y, Z, vX, vY, vZ;
+// Sat-Pos Cache: Kepler nur an Stuetzstellen t0, t0+SATC_DT (pos+vel),
+// dazwischen kubische Hermite-Interpolation (Fehler < 1mm bei 60s),
+// clock_corr/drift linear
+static void satc_node(SATC_t *c, int n, EPHEM_t *eph, int week, double t) {
+    GPS_SatellitePositionVelocity_Ephem(
+        week, t, *eph,
+        c->cc+n, c->cd+n, c->X+n, c->Y+n, c->Z+n, c->vX+n, c->vY+n, c->vZ+n
+    );
+}
+
+static void satc_pos(SATC_t *c, EPHEM_t *eph, int week, double t, SAT_t *sat, int vel) {
+    double h = SATC_DT;
+    double s, s2, s3, h00, h10, h01, h11;
+    double t0;
+
+    if (c->eph != eph || c->week != week || t < c->t0 || t > c->t0 + h) {
+        t0 = floor(t/h)*h;
+        if (c->eph == eph && c->week == week && t0 == c->t0 + h) {
+            c->X[0] = c->X[1];   c->Y[0] = c->Y[1];   c->Z[0] = c->Z[1];
+            c->vX[0] = c->vX[1]; c->vY[0] = c->vY[1]; c->vZ[0] = c->vZ[1];
+            c->cc[0] = c->cc[1]; c->cd[0] = c->cd[1];
+        }
+        else satc_node(c, 0, eph, week, t0);
+        satc_node(c, 1, eph, week, t0 + h);
+        c->eph = eph;
+        c->week = week;
+        c->t0 = t0;
+    }
+
+    s = (t - c->t0)/h; s2 = s*s; s3 = s2*s;
+    h00 = 2*s3 - 3*s2 + 1;
+    h10 = (s3 - 2*s2 + s)*h;
+    h01 = -2*s3 + 3*s2;
+    h11 = (s3 - s2)*h;
+    sat->X = h00*c->X[0] + h10*c->vX[0] + h01*c->X[1] + h11*c->vX[1];
+    sat->Y = h00*c->Y[0] + h10*c->vY[0] + h01*c->Y[1] + h11*c->vY[1];
+    sat->Z = h00*c->Z[0] + h10*c->vZ[0] + h01*c->Z[1] + h11*c->vZ[1];
+    sat->clock_corr = c->cc[0] + s*(c->cc[1] - c->cc[0]);
+
+    if (vel >= 2) {
+        h00 = (6*s2 - 6*s)/h;
+        h10 = 3*s2 - 4*s + 1;
+        h01 = -h00;
+        h11 = 3*s2 - 2*s;
+        sat->vX = h00*c->X[0] + h10*c->vX[0] + h01*c->X[1] + h11*c->vX[1];
+        sat->vY = h00*c->Y[0] + h10*c->vY[0] + h01*c->Y[1] + h11*c->vY[1];
+        sat->vZ = h00*c->Z[0] + h10*c->vZ[0] + h01*c->Z[1] + h11*c->vZ[1];
+        sat->clock_drift = c->cd[0] + s*(c->cd[1] - c->cd[0]);
+    }
+}
+
+static int calc_satpos_alm(gpx_t *gpx, double t, SAT_t *satp, SATC_t *satc, ui8_t *vis) {
     int j;
     int week;
-    double cl_corr, cl_drift;
     int rollover = 0;
     EPHEM_t *alm = gpx->gps.alm;
 
@@ -860,39 +928,42 @@ static int calc_satpos_alm(gpx_t *gpx, double t, SAT_t *satp) {
             week = alm[j].week - rollover;
             /*if (j == 1)*/ gpx->week = week + gpx->gps.WEEK1024epoch*1024;
 
-            if (gpx->gps.opt_vel >= 2) {
-                GPS_SatellitePositionVelocity_Ephem(
-                    week, t, alm[j],
-                    &cl_corr, &cl_drift, &X, &Y, &Z, &vX, &vY, &vZ
-                );
-                satp[alm[j].prn].clock_drift = cl_drift;
-                satp[alm[j].prn].vX = vX;
-                satp[alm[j].prn].vY = vY;
-                satp[alm[j].prn].vZ = vZ;
-            }
-            else {
-                GPS_SatellitePosition_Ephem(
-                    week, t, alm[j],
-                    &cl_corr, &X, &Y, &Z
-                );
+            if (vis[alm[j].prn]) {
+                satc_pos(satc+alm[j].prn, alm+j, week, t, satp+alm[j].prn, gpx->gps.opt_vel);
             }
+        }
+    }
+
+    return 0;
+}
+
+// ephs-Index: Ephemeriden je PRN (Reihenfolge wie in der Datei)
+static int eph_index(GPS_t *gps) {
+    EPHEM_t *eph = gps->ephs;
+    int count, j, n;
 
-            satp[alm[j].prn].X = X;
-            satp[alm[j].prn].Y = Y;
-            satp[alm[j].prn].Z = Z;
-            satp[alm[j].prn].clock_corr = cl_corr;
+    for (j = 0; j < 34; j++) gps->ephofs[j] = 0;
+    for (count = 0; eph[count].prn > 0; count++) {
+        if (eph[count].prn < 33) gps->ephofs[eph[count].prn+1] += 1;
+    }
+    for (j = 1; j < 34; j++) gps->ephofs[j] += gps->ephofs[j-1];
 
+    gps->ephidx = calloc(count+1, sizeof(int));
+    if (gps->ephidx == NULL) return -1;
+
+    for (j = 1; j < 33; j++) {
+        n = gps->ephofs[j];
+        for (count = 0; eph[count].prn > 0; count++) {
+            if (eph[count].prn == j) gps->ephidx[n++] = count;
         }
     }
 
     return 0;
 }
 
-static int calc_satpos_rnx2(gpx_t *gpx, double t, SAT_t *satp) {
-    double X, Y, Z, vX, vY, vZ;
-    int j;
+static int calc_satpos_rnx2(gpx_t *gpx, double t, SAT_t *satp, SATC_t *satc, ui8_t *vis) {
+    int j, n;
     int week;
-    double cl_corr, cl_drift;
     double tdiff, td;
     int count, count0, satfound;
     int rollover = 0;
@@ -900,15 +971,17 @@ static int calc_satpos_rnx2(gpx_t *gpx, double t, SAT_t *satp) {
 
     for (j = 1; j < 33; j++) {
 
-        count = count0 = 0;
+        count0 = 0;
         satfound = 0;
 
         // Woche hat 604800 sec
         tdiff = WEEKSEC;
 
-        while (eph[count].prn > 0) {
+        for (n = gpx->gps.ephofs[j]; n < gpx->gps.ephofs[j+1]; n++) {
+
+            count = gpx->gps.ephidx[n];
 
-            if (eph[count].prn == j && eph[count].health == 0) {
+            if (eph[count].health == 0) {
 
                 satfound += 1;
 
@@ -924,32 +997,11 @@ static int calc_satpos_rnx2(gpx_t *gpx, double t, SAT_t *satp) {
                     count0 = count;
                 }
             }
-            count += 1;
         }
 
-        if ( satfound )
+        if ( satfound && vis[j] )
         {
-            if (gpx->gps.opt_vel >= 2) {
-                GPS_SatellitePositionVelocity_Ephem(
-                    week, t, eph[count0],
-                    &cl_corr, &cl_drift, &X, &Y, &Z, &vX, &vY, &vZ
-                );
-                satp[j].clock_drift = cl_drift;
-                satp[j].vX = vX;
-                satp[j].vY = vY;
-                satp[j].vZ = vZ;
-            }
-            else {
-                GPS_SatellitePosition_Ephem(
-                    week, t, eph[count0],
-                    &cl_corr, &X, &Y, &Z
-                );
-            }
-
-            satp[j].X = X;
-            satp[j].Y = Y;
-            satp[j].Z = Z;
-            satp[j].clock_corr = cl_corr;
+            satc_pos(satc+j, eph+count0, week, t, satp+j, gpx->gps.opt_vel);
             satp[j].ephtime = eph[count0].toe;
         }
 
@@ -983,6 +1035,7 @@ static int get_pseudorange(gpx_t *gpx) {
     double  pr0, prj;
     ui8_t prn_le[12*5+4]; // le - little endian
     ui8_t prns[12]; // PRNs in data
+    ui8_t vis[33];
     RANGE_t range[33];
 
     memset(prn_le, 0, sizeof(prn_le));
@@ -1011,14 +1064,19 @@ static int get_pseudorange(gpx_t *gpx) {
     prn12(&gpx->gps, prn_le, prns);
 
 
+    // nur PRNs im Frame
+    memset(vis, 0, sizeof(vis));
+    for (j = 0; j < 12; j++) vis[prns[j]] = 1;
+    vis[0] = 0;
+
     // GPS Sat Pos (& Vel)
-    if (gpx->gps.almanac) calc_satpos_alm( gpx, gpstime/1000.0, gpx->gps.sat);
-    if (gpx->gps.ephem)   calc_satpos_rnx2(gpx, gpstime/1000.0, gpx->gps.sat);
+    if (gpx->gps.almanac) calc_satpos_alm( gpx, gpstime/1000.0, gpx->gps.sat, gpx->gps.satc, vis);
+    if (gpx->gps.ephem)   calc_satpos_rnx2(gpx, gpstime/1000.0, gpx->gps.sat, gpx->gps.satc, vis);
 
     // GPS Sat Pos t -= 1s
     if (gpx->gps.opt_vel == 1) {
-        if (gpx->gps.almanac) calc_satpos_alm( gpx, gpstime/1000.0-1, gpx->gps.sat1s);
-        if (gpx->gps.ephem)   calc_satpos_rnx2(gpx, gpstime/1000.0-1, gpx->gps.sat1s);
+        if (gpx->gps.almanac) calc_satpos_alm( gpx, gpstime/1000.0-1, gpx->gps.sat1s, gpx->gps.satc1s, vis);
+        if (gpx->gps.ephem)   calc_satpos_rnx2(gpx, gpstime/1000.0-1, gpx->gps.sat1s, gpx->gps.satc1s, vis);
     }
 
     k = 0;
@@ -1351,6 +1409,128 @@ static int get_GPSkoord(gpx_t *gpx, int N) {
 }
 
 
+// WLS (Gauss-Newton), alle Sats, Gewicht sin^2(elev),
+// Startwert: letzte Position (sonst bancroft);
+// RAIM: solange sigma > gps.raim, Sat weglassen (N > 5), der sigma am meisten verkleinert
+static double wls_fix(int N, SAT_t *sats, double pos_ecef[3], double *cc) {
+    double w[12], res[12], dpos_ecef[3];
+    double X, Y, Z, r, up, dcc;
+    double sw = 0.0, swr = 0.0;
+    int i, j, it;
+
+    for (it = 0; it < 10; it++) {
+        r = dist(0, 0, 0, pos_ecef[0], pos_ecef[1], pos_ecef[2]);
+        for (i = 0; i < N; i++) {
+            w[i] = 1.0;
+            if (r > 6000e3) {
+                X = sats[i].X - pos_ecef[0];
+                Y = sats[i].Y - pos_ecef[1];
+                Z = sats[i].Z - pos_ecef[2];
+                up = (X*pos_ecef[0] + Y*pos_ecef[1] + Z*pos_ecef[2]) / (r*sqrt(X*X+Y*Y+Z*Z));
+                if (up < 0.1) up = 0.1;
+                w[i] = up*up;
+            }
+        }
+        if (NAV_LinP_W(N, sats, w, pos_ecef, *cc, dpos_ecef, &dcc, res) != 0) return -1;
+        for (j = 0; j < 3; j++) pos_ecef[j] += dpos_ecef[j];
+        *cc += dcc;
+        if (dist(0, 0, 0, dpos_ecef[0], dpos_ecef[1], dpos_ecef[2]) < 0.01) break;
+    }
+    if (it == 10) return -1;
+
+    if (N == 4) return 0.0;
+    for (i = 0; i < N; i++) {
+        sw  += w[i];
+        swr += w[i]*res[i]*res[i];
+    }
+    return sqrt( swr/sw * N/(N-4) );
+}
+
+static int get_GPSwls(gpx_t *gpx, int N) {
+    double lat, lon, alt;
+    double vH, vD, vU;
+    double pos_ecef[3], pos0_ecef[3], vel_ecef[3], dvel_ecef[3];
+    double cc, cc0, rx_cl_bias;
+    double sigma, sigma0, DOP[4];
+    SAT_t Sat_B[12];
+    SAT_t Sat_C[12];
+    int j, k, n, exN;
+
+    gpx->lat = gpx->lon = gpx->alt = 0;
+
+    if (N < 4) return 0;
+    for (j = 0; j < N; j++) Sat_B[j] = gpx->gps.sat[gpx->gps.prn[j]];
+
+    sigma = -1;
+    if (gpx->gps.fix) {
+        for (j = 0; j < 3; j++) pos_ecef[j] = gpx->gps.pos_ecef[j];
+        cc = gpx->gps.cc;
+        sigma = wls_fix(N, Sat_B, pos_ecef, &cc);
+    }
+    if (sigma < 0) {
+        if (NAV_bancroft1(N, Sat_B, pos_ecef, &cc) != 0) return 0;
+        sigma = wls_fix(N, Sat_B, pos_ecef, &cc);
+        if (sigma < 0) { gpx->gps.fix = 0; return 0; }
+    }
+
+    while (sigma > gpx->gps.raim && N > 5) {
+        exN = -1;
+        sigma0 = sigma;
+        for (n = 0; n < N; n++) {
+            k = 0;
+            for (j = 0; j < N; j++) {
+                if (j != n) Sat_C[k++] = Sat_B[j];
+            }
+            for (j = 0; j < 3; j++) pos0_ecef[j] = pos_ecef[j];
+            cc0 = cc;
+            sigma = wls_fix(N-1, Sat_C, pos0_ecef, &cc0);
+            if (sigma >= 0 && sigma < sigma0) {
+                sigma0 = sigma;
+                exN = n;
+            }
+        }
+        if (exN < 0) break;
+
+        if (gpx->gps.prn[exN] == gpx->gps.prn32next) gpx->gps.prn32toggle ^= 0x1;
+        for (k = exN; k < N-1; k++) {
+            Sat_B[k] = Sat_B[k+1];
+            gpx->gps.prn[k] = gpx->gps.prn[k+1];
+        }
+        N = N-1;
+        sigma = wls_fix(N, Sat_B, pos_ecef, &cc);
+        if (sigma < 0) { gpx->gps.fix = 0; return 0; }
+    }
+
+    for (j = 0; j < 3; j++) gpx->gps.pos_ecef[j] = pos_ecef[j];
+    gpx->gps.cc = cc;
+    gpx->gps.fix = 1;
+
+    ecef2elli(pos_ecef[0], pos_ecef[1], pos_ecef[2], &lat, &lon, &alt);
+    gpx->lat = lat;
+    gpx->lon = lon;
+    gpx->alt = alt;
+    gpx->diter = sigma;
+    gpx->dop = -1;
+    if (calc_DOPn(N, Sat_B, pos_ecef, DOP) == 0) {
+        gpx->dop = sqrt(DOP[0]+DOP[1]+DOP[2]+DOP[3]);
+    }
+
+    if (gpx->gps.opt_vel == 4) {
+        vel_ecef[0] = vel_ecef[1] = vel_ecef[2] = 0;
+        NAV_LinV(N, Sat_B, pos_ecef, vel_ecef, 0.0, dvel_ecef, &rx_cl_bias);
+        for (j=0; j<3; j++) vel_ecef[j] += dvel_ecef[j];
+        NAV_LinV(N, Sat_B, pos_ecef, vel_ecef, rx_cl_bias, dvel_ecef, &rx_cl_bias);
+        for (j=0; j<3; j++) vel_ecef[j] += dvel_ecef[j];
+        get_GPSvel(lat, lon, vel_ecef, &vH, &vD, &vU);
+        gpx->vH = vH;
+        gpx->vD = vD;
+        gpx->vU = vU;
+    }
+
+    return N;
+}
+
+
 /* ------------------------------------------------------------------------------------ */
 
 #define rs_N 255
@@ -1402,7 +1582,8 @@ static int print_position(gpx_t *gpx, int ec) {  // GPS-Hoehe ueber Ellipsoid
     if (!err3 && (gpx->gps.almanac || gpx->gps.ephem)) {
         k = get_pseudorange(gpx);
         if (k >= 4) {
-            n = get_GPSkoord(gpx, k);
+            if (gpx->gps.opt_vergps == 0) n = get_GPSwls(gpx, k);
+            else                          n = get_GPSkoord(gpx, k);
         }
     }
 
@@ -1434,11 +1615,11 @@ static int print_position(gpx_t *gpx, int ec) {  // GPS-Hoehe ueber Ellipsoid
                     fprintf(stdout,"  vH: %4.1f  D: %5.1f  vV: %3.1f ", gpx->vH, gpx->vD, gpx->vU);
                 }
                 if (gpx->option.vbs) {
-                    if (gpx->gps.opt_vergps != 2) {
+                    if (gpx->gps.opt_vergps == 1 || gpx->gps.opt_vergps == 8) {
                         fprintf(stdout, " DOP[%02d,%02d,%02d,%02d] %.1f",
                                        gpx->sats[0], gpx->sats[1], gpx->sats[2], gpx->sats[3], gpx->dop);
                     }
-                    else {  // wenn gpx->gps.opt_vergps=2, dann n=N=k(-1)
+                    else {  // wenn gpx->gps.opt_vergps=0,2, dann n=N=k(-1)
                         fprintf(stdout, " DOP[");
                         for (j = 0; j < n; j++) {
                             fprintf(stdout, "%d", gpx->gps.prn[j]);
@@ -1589,8 +1770,10 @@ int main(int argc, char *argv[]) {
     int option_lp = 0;
     int option_dc = 0;
     int option_noLUT = 0;
+    int option_noVEC = 0;
     int option_softin = 0;
     int option_pcmraw = 0;
+    char *shm_name = NULL;
     int sel_wavch = 0;     // audio channel: left
     int spike = 0;
     int fileloaded = 0;
@@ -1629,6 +1812,7 @@ int main(int argc, char *argv[]) {
     gpx.gps.prn32toggle = 0x1;
     gpx.gps.dop_limit = 9.9;
     gpx.gps.d_err = 10000;
+    gpx.gps.raim = 500;
     gpx.gps.exSat = -1;
     gpx.gps.WEEK1024epoch = 1; // SEM almanac, GPS epoch (1: 1999-2019)
 
@@ -1653,13 +1837,15 @@ int main(int argc, char *argv[]) {
             fprintf(stderr, "       -e, --ephem    <ephemperisRinex>\n");
             fprintf(stderr, "       -a, --almanac  <almanacSEM>\n");
             fprintf(stderr, "           --gpsepoch <n> (2019-04-07: n=2)\n");
-            fprintf(stderr, "       -g1          (verbose GPS:   4 sats)\n");
-            fprintf(stderr, "       -g2          (verbose GPS: all sats)\n");
+            fprintf(stderr, "       -g1          (verbose GPS:   4 sats, min. GDOP)\n");
+            fprintf(stderr, "       -g2          (verbose GPS: all sats, bancroft)\n");
+            fprintf(stderr, "                    (default: all sats, WLS)\n");
             fprintf(stderr, "       -gg          (vverbose GPS)\n");
             fprintf(stderr, "       --crc        (CRC check GPS)\n");
             fprintf(stderr, "       --ecc        (Reed-Solomon)\n");
             fprintf(stderr, "       --ths <x>    (peak threshold; default=%.1f)\n", thres);
             fprintf(stderr, "       --json       (JSON output)\n");
+            fprintf(stderr, "       --shm <name> (IQ input: shared memory, iq_shm)\n");
             return 0;
         }
         else if ( (strcmp(*argv, "--vel") == 0) ) {
@@ -1796,12 +1982,18 @@ int main(int argc, char *argv[]) {
         else if   (strcmp(*argv, "--lpFM") == 0) { option_lp |= LP_FM; }  // FM lowpass
         else if   (strcmp(*argv, "--dc") == 0) { option_dc = 1; }
         else if   (strcmp(*argv, "--noLUT") == 0) { option_noLUT = 1; }
+        else if   (strcmp(*argv, "--noVEC") == 0) { option_noVEC = 1; }
         else if   (strcmp(*argv, "--min") == 0) {
             option_min = 1;
         }
         else if   (strcmp(*argv, "--ngp") == 0) { gpx.option.ngp = 1; }  // RS92-NGP, RS92-D: 1680 MHz
         else if   (strcmp(*argv, "--dbg" ) == 0) { gpx.option.dbg = 1; }
         else if (strcmp(*argv, "--rawhex") == 0) { rawhex = 2; }  // raw hex input
+        else if   (strcmp(*argv, "--shm") == 0) {
+            ++argv;
+            if (*argv) shm_name = *argv; else return -1;
+            option_pcmraw = 1;
+        }
         else if (strcmp(*argv, "-") == 0) {
             int sample_rate = 0, bits_sample = 0, channels = 0;
             ++argv;
@@ -1836,6 +2028,7 @@ int main(int argc, char *argv[]) {
         }
         fclose(fp_alm);
         if (!option_der) gpx.gps.d_err = 4000;
+        gpx.gps.raim = 500;
     }
     if (fp_eph) {
         /* i = read_RNXephemeris(fp_eph, eph);
@@ -1845,12 +2038,17 @@ int main(int argc, char *argv[]) {
            }
            fclose(fp_eph); */
         gpx.gps.ephs = read_RNXpephs(fp_eph);
+        if (gpx.gps.ephs && eph_index(&gpx.gps) < 0) {
+            free(gpx.gps.ephs);
+            gpx.gps.ephs = NULL;
+        }
         if (gpx.gps.ephs) {
             gpx.gps.ephem = 1;
             gpx.gps.almanac = 0;
         }
         fclose(fp_eph);
         if (!option_der) gpx.gps.d_err = 1000;
+        gpx.gps.raim = 50;
     }
 
     if (option_iq == 5 && option_dc) option_lp |= LP_FM;
@@ -1859,6 +2057,7 @@ int main(int argc, char *argv[]) {
     // LUT recommonded if decM > 2
     //
     if (option_noLUT && option_iq == 5) dsp.opt_nolut = 1; else dsp.opt_nolut = 0;
+    if (option_noVEC && option_iq == 5) dsp.opt_novec = 1; else dsp.opt_novec = 0;
 
 
     gpx.option.crc = 1;
@@ -1896,7 +2095,15 @@ int main(int argc, char *argv[]) {
             if (option_iq) sel_wavch = 0;
 
             pcm.sel_ch = sel_wavch;
-            if (option_pcmraw == 0) {
+            if (shm_name) {
+                k = shm_attach(&dsp, &pcm, shm_name);
+                if ( k < 0 ) {
+                    fclose(fp);
+                    fprintf(stderr, "error: shm %s\n", shm_name);
+                    return -1;
+                }
+            }
+            else if (option_pcmraw == 0) {
                 k = read_wav_header(&pcm, fp);
                 if ( k < 0 ) {
                     fclose(fp);
@@ -2083,6 +2290,7 @@ int main(int argc, char *argv[]) {
     }
 
     if (gpx.gps.ephs) free(gpx.gps.ephs);
+    if (gpx.gps.ephidx) free(gpx.gps.ephidx);
 
     fclose(fp);
 
@@ -29,6 +29,7 @@
 
 
 #define MAX_DEG 254  // max N-1
+#define MAX_GTR 32   // rs_gtab(): max R
 
 
 typedef struct {
@@ -48,6 +49,7 @@ typedef struct {
     ui8_t p; ui8_t ip; // p*ip = 1 mod N
     ui8_t g[MAX_DEG+1];  // ohne g[] eventuell als init_return
     GF_t GF;
+    ui8_t gT[256][MAX_GTR];  // gT[c][j] = c*g[j], j < R : cw mod g(X)
 } RS_t;
 
 
@@ -101,6 +103,11 @@ int rs_encode(RS_t *RS, ui8_t cw[]);
 int rs_decode(RS_t *RS, ui8_t cw[], ui8_t *err_pos, ui8_t *err_val);
 int rs_decode_ErrEra(RS_t *RS, ui8_t cw[], int nera, ui8_t era_pos[], ui8_t *err_pos, ui8_t *err_val);
 int rs_decode_bch_gf2t2(RS_t *RS, ui8_t cw[], ui8_t *err_pos, ui8_t *err_val);
+int rs_decode_RS255(RS_t *RS, ui8_t cw[], ui8_t *err_pos, ui8_t *err_val);
+int rs_decode_RS255ccsds(RS_t *RS, ui8_t cw[], ui8_t *err_pos, ui8_t *err_val);
+int rs_decode_BCH64(RS_t *RS, ui8_t cw[], ui8_t *err_pos, ui8_t *err_val);
+int rs_check(RS_t *RS, ui8_t cw[]);
+int rs_decode_batch(RS_t *RS, int n, ui8_t *cw[], int *errors, ui8_t *err_pos, ui8_t *err_val);
 
 #endif
 
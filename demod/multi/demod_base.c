@@ -16,6 +16,10 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sched.h> // sched_yield()
+#include <time.h>  // nanosleep()
+#include <stdint.h> // uintptr_t
+#include <unistd.h> // sysconf()
 
 #include "demod_base.h"
 
@@ -24,42 +28,76 @@
 /* ------------------------------------------------------------------------------------ */
 
 
-static void raw_dft(dft_t *dft, float complex *Z) {
-    int s, l, l2, i, j, k;
-    float complex  w1, w2, T;
+// bit-reversal permutation: table for N, N/2 via brv[i]>>1 (i < N/2)
+static void dft_bitrev(dft_t *dft, float complex *Z, int sh) {
+    int i, j;
+    int N = dft->N >> sh;
+    float complex T;
 
-    j = 1;
-    for (i = 1; i < dft->N; i++) {
+    for (i = 1; i < N; i++) {
+        j = dft->brv[i] >> sh;
         if (i < j) {
-            T = Z[j-1];
-            Z[j-1] = Z[i-1];
-            Z[i-1] = T;
+            T = Z[j];
+            Z[j] = Z[i];
+            Z[i] = T;
         }
-        k = dft->N/2;
-        while (k < j) {
-            j = j - k;
-            k = k/2;
+    }
+}
+
+// radix-2^2 butterflies, twiddle tables tw[l2-1+j] = exp(-I*pi*j/l2)
+static void dft_stages(dft_t *dft, float complex *Z, int log2n) {
+    int s, i, j, l2, l4;
+    int a, b, c, d;
+    int N = 1 << log2n;
+    float complex  w1, w2, T, A, B, C, D;
+    float complex *tw1, *tw2;
+
+    s = 0;
+    if (log2n & 1) { // radix-2 stage, w=1
+        for (i = 0; i < N; i += 2) {
+            T = Z[i+1];
+            Z[i+1] = Z[i] - T;
+            Z[i]   = Z[i] + T;
         }
-        j = j + k;
+        s = 1;
     }
 
-    for (s = 0; s < dft->LOG2N; s++) {
+    for ( ; s < log2n; s += 2) {
         l2 = 1 << s;
-        l  = l2 << 1;
-        w1 = (float complex)1.0;
-        w2 = dft->ew[s]; // cexp(-I*M_PI/(float)l2)
-        for (j = 1; j <= l2; j++) {
-            for (i = j; i <= dft->N; i += l) {
-                k = i + l2;
-                T = Z[k-1] * w1;
-                Z[k-1] = Z[i-1] - T;
-                Z[i-1] = Z[i-1] + T;
+        l4 = l2 << 2;
+        tw1 = dft->tw + l2-1;   // stage s
+        tw2 = dft->tw + 2*l2-1; // stage s+1
+        for (i = 0; i < N; i += l4) {
+            for (j = 0; j < l2; j++) {
+                a = i + j;
+                b = a + l2;
+                c = b + l2;
+                d = c + l2;
+                w1 = tw1[j];
+                w2 = tw2[j];
+                T = Z[b] * w1;
+                A = Z[a] + T;
+                B = Z[a] - T;
+                T = Z[d] * w1;
+                C = Z[c] + T;
+                D = Z[c] - T;
+                T = C * w2;
+                Z[a] = A + T;
+                Z[c] = A - T;
+                T = D * w2;
+                T = cimag(T) - I*creal(T); // *(-I)
+                Z[b] = B + T;
+                Z[d] = B - T;
             }
-            w1 = w1 * w2;
         }
     }
 }
 
+static void raw_dft(dft_t *dft, float complex *Z) {
+    dft_bitrev(dft, Z, 0);
+    dft_stages(dft, Z, dft->LOG2N);
+}
+
 static void cdft(dft_t *dft, float complex *z, float complex *Z) {
     int i;
     for (i = 0; i < dft->N; i++)  Z[i] = z[i];
@@ -67,17 +105,69 @@ static void cdft(dft_t *dft, float complex *z, float complex *Z) {
 }
 
 static void rdft(dft_t *dft, float *x, float complex *Z) {
-    int i;
-    for (i = 0; i < dft->N; i++)  Z[i] = (float complex)x[i];
-    raw_dft(dft, Z);
+// real input: N/2-point complex DFT of z[n]=x[2n]+I*x[2n+1], then split
+    int k;
+    int N  = dft->N;
+    int N2 = dft->N/2;
+    float complex *W = dft->tw + N2-1; // exp(-2*pi*I*k/N)
+    float complex Zk, Zm, E, O;
+
+    for (k = 0; k < N2; k++)  Z[k] = x[2*k] + I*x[2*k+1];
+    dft_bitrev(dft, Z, 1);
+    dft_stages(dft, Z, dft->LOG2N-1);
+
+    Zk = Z[0];
+    Z[0]  = creal(Zk) + cimag(Zk);
+    Z[N2] = creal(Zk) - cimag(Zk);
+    for (k = 1; k <= N2/2; k++) {
+        Zk = Z[k];
+        Zm = Z[N2-k];
+        E = 0.5f*(Zk + conj(Zm));
+        O = 0.5f*(Zk - conj(Zm));
+        O = W[k] * (cimag(O) - I*creal(O)); // W^k * O/I
+        Z[k]    = E + O;
+        Z[N-k]  = conj(E + O);
+        Z[N2-k] = conj(E - O);
+        Z[N2+k] = E - O;
+    }
 }
 
-static void Nidft(dft_t *dft, float complex *Z, float complex *z) {
-    int i;
-    for (i = 0; i < dft->N; i++)  z[i] = conj(Z[i]);
-    raw_dft(dft, z);
-    // idft():
-    // for (i = 0; i < dft->N; i++)  z[i] = conj(z[i])/(float)dft->N; // hier: z reell
+static void rNidft(dft_t *dft, float complex *Z, float complex *z) {
+// N*idft(Z) for Z[N-k]=conj(Z[k]), i.e. z reell: N/2-point complex DFT
+    int k;
+    int N2 = dft->N/2;
+    float complex *W = dft->tw + N2-1; // exp(-2*pi*I*k/N)
+    float complex E, O;
+
+    for (k = 0; k < N2; k++) {
+        E = Z[k] + Z[k+N2];
+        O = (Z[k] - Z[k+N2]) * conj(W[k]);
+        z[k] = conj(E + I*O);
+    }
+    dft_bitrev(dft, z, 1);
+    dft_stages(dft, z, dft->LOG2N-1);
+
+    for (k = N2-1; k >= 0; k--) {
+        E = z[k];
+        z[2*k+1] = -cimag(E); // conj
+        z[2*k]   =  creal(E);
+    }
+}
+
+static int dft_tables(dft_t *dft) {
+    int i, j, k, l2;
+
+    for (i = 0; i < dft->N; i++) {
+        j = 0;
+        for (k = 0; k < dft->LOG2N; k++) j |= ((i >> k) & 1) << (dft->LOG2N-1-k);
+        dft->brv[i] = j;
+    }
+
+    for (l2 = 1; l2 < dft->N; l2 <<= 1) {
+        for (j = 0; j < l2; j++) dft->tw[l2-1+j] = cexp(-I*M_PI*j/(double)l2);
+    }
+
+    return 0;
 }
 
 static float bin2freq0(dft_t *dft, int k) {
@@ -150,6 +240,7 @@ static int getCorrDFT(dsp_t *dsp, float thres) {
     float mx2 = 0.0;
     float re_cx = 0.0;
     float xnorm = 1;
+    float xmean = 0.0; // opt_dc: X[0]=0
     ui32_t mpos = 0;
     ui32_t pos = dsp->sample_out;
 
@@ -180,14 +271,15 @@ static int getCorrDFT(dsp_t *dsp, float thres) {
         dc /= 2.0*(float)dsp->L;
         dsp->DFT.X[0] -= dsp->DFT.N * dc  ;//* 0.95;
         */
+        // X[0]=0: xn[i] - mean, mean = X[0]/N (i < N);
+        // no IDFT/DFT round trip, mean only needed for xnorm
+        xmean = creal(dsp->DFT.X[0])/(float)dsp->DFT.N;
         dsp->DFT.X[0] = 0;
-        Nidft(&dsp->DFT, dsp->DFT.X, dsp->DFT.cx);
-        for (i = 0; i < dsp->DFT.N; i++) dsp->DFT.xn[i] = creal(dsp->DFT.cx[i])/(float)dsp->DFT.N;
     }
 
     for (i = 0; i < dsp->DFT.N; i++) dsp->DFT.Z[i] = dsp->DFT.X[i]*dsp->DFT.Fm[i];
 
-    Nidft(&dsp->DFT, dsp->DFT.Z, dsp->DFT.cx);
+    rNidft(&dsp->DFT, dsp->DFT.Z, dsp->DFT.cx);
 
 
     // relativ Peak - Normierung erst zum Schluss;
@@ -211,7 +303,7 @@ static int getCorrDFT(dsp_t *dsp, float thres) {
 
     //xnorm = sqrt(dsp->qs[(mpos + 2*dsp->M) % dsp->M]); // Nvar = L
     xnorm = 0.0;
-    for (i = 0; i < dsp->L; i++) xnorm += dsp->DFT.xn[mp-i]*dsp->DFT.xn[mp-i];
+    for (i = 0; i < dsp->L; i++) xnorm += (dsp->DFT.xn[mp-i]-xmean)*(dsp->DFT.xn[mp-i]-xmean);
     xnorm = sqrt(xnorm);
 
     mx /= xnorm*dsp->DFT.N;
@@ -233,13 +325,12 @@ static int getCorrDFT(dsp_t *dsp, float thres) {
             while (i < dsp->DFT.N) dsp->DFT.xn[i++] = 0.0;
             rdft(&dsp->DFT, dsp->DFT.xn, dsp->DFT.X);
 
+            xmean = creal(dsp->DFT.X[0])/(float)dsp->DFT.N;
             dsp->DFT.X[0] = 0;
-            Nidft(&dsp->DFT, dsp->DFT.X, dsp->DFT.cx);
-            for (i = 0; i < dsp->DFT.N; i++) dsp->DFT.xn[i] = creal(dsp->DFT.cx[i])/(float)dsp->DFT.N;
 
             for (i = 0; i < dsp->DFT.N; i++) dsp->DFT.Z[i] = dsp->DFT.X[i]*dsp->DFT.Fm[i];
 
-            Nidft(&dsp->DFT, dsp->DFT.Z, dsp->DFT.cx);
+            rNidft(&dsp->DFT, dsp->DFT.Z, dsp->DFT.cx);
 
             mx2 = 0.0;                                      // t = L-1
             for (i = dsp->L-1; i < dsp->K + dsp->L; i++) {  // i=t .. i=t+K < t+1+K
@@ -256,7 +347,7 @@ static int getCorrDFT(dsp_t *dsp, float thres) {
             mpos = pos - (dsp->K + dsp->L-1) + mp; // t = L-1
 
             xnorm = 0.0;
-            for (i = 0; i < dsp->L; i++) xnorm += dsp->DFT.xn[mp-i]*dsp->DFT.xn[mp-i];
+            for (i = 0; i < dsp->L; i++) xnorm += (dsp->DFT.xn[mp-i]-xmean)*(dsp->DFT.xn[mp-i]-xmean);
             xnorm = sqrt(xnorm);
 
             mx /= xnorm*dsp->DFT.N;
@@ -466,74 +557,44 @@ static int f32read_csample(dsp_t *dsp, float complex *z) {
 
 
 volatile int bufeof = 0;      // threads exit
-volatile int rbf1;
-static volatile int rbf;
 
 
-static int __f32read_cblock_nocond(dsp_t *dsp) { // blk
-                                      // faster; however if #{fqs} > #{cores}, very very slow, quasi-lock
-    int n;
-    int BL = dsp->decM * blk_sz;
-    int len = BL;
-
-    if (bufeof) return 0;
-
-    pthread_mutex_lock( dsp->thd->mutex );
-
-    if (rbf == 0)
-    {
-        if (dsp->bps == 8) { //uint8
-            ui8_t u[2*BL];
-            len = fread( u, dsp->bps/8, 2*BL, dsp->fp) / 2;
-            for (n = 0; n < len; n++) dsp->thd->blk[n] = (u[2*n]-128)/128.0 + I*(u[2*n+1]-128)/128.0;
-        }
-        else if (dsp->bps == 16) { //int16
-            short b[2*BL];
-            len = fread( b, dsp->bps/8, 2*BL, dsp->fp) / 2;
-            for (n = 0; n < len; n++) dsp->thd->blk[n] = b[2*n]/32768.0 + I*b[2*n+1]/32768.0;
-        }
-        else { // dsp->bps == 32   //float32
-            float f[2*BL];
-            len = fread( f, dsp->bps/8, 2*BL, dsp->fp) / 2;
-            for (n = 0; n < len; n++) dsp->thd->blk[n] = f[2*n] + I*f[2*n+1];
-        }
-        if (len < BL) bufeof = 1;
-
-        rbf = rbf1; // set all bits
-    }
-    pthread_mutex_unlock( dsp->thd->mutex );
-
-    while ((rbf & dsp->thd->tn_bit) == 0) ;  // only if #{fqs} leq #{cores} ...
-
-    for (n = 0; n < dsp->decM; n++) dsp->decMbuf[n] = dsp->thd->blk[dsp->decM*dsp->blk_cnt + n];
-
-    dsp->blk_cnt += 1;
-    if (dsp->blk_cnt == blk_sz) {
-        pthread_mutex_lock( dsp->thd->mutex );
-        rbf &= ~(dsp->thd->tn_bit); // clear bit(tn)
-        dsp->blk_cnt = 0;
-        pthread_mutex_unlock( dsp->thd->mutex );
-    }
-
-    return len;
+// IQ block ring
+//
+// reader thread (thd_ring): f32_cblk() -> slot wr%depth, then wr += 1
+// consumer tn: read cursor cons[tn].rd, decM samples per f32read_cblock()
+// no locks; waiting reader/consumer: spin, sched_yield(), then short sleep
+// default: reader waits for the slowest consumer (file replay, lossless);
+// opt_drop: reader never waits, consumer behind by >= depth blocks skips
+//           to the oldest valid block (seq[] checks overwritten slots)
+// opt_pfb: reader runs the polyphase part of a channelizer once for all
+//          consumers, slot holds M polyphase sums per output sample;
+//          consumer: DFT bin k (dot product) + fine mix, no decimation filter
+
+static void ring_pause(int *spin) {
+    struct timespec ts = { 0, 100000 }; // 100us
+    *spin += 1;
+    if (*spin < 64) return;
+    if (*spin < 256) sched_yield();
+    else nanosleep(&ts, NULL);
 }
 
-static int f32_cblk(dsp_t *dsp) {
+static int f32_cblk(ring_t *rb, float complex *blk) {
 
     int n;
-    int BL = dsp->decM * blk_sz;
+    int BL = rb->blk_len;
     int len = BL;
     float x, y;
 
-    if (dsp->bps == 8) { //uint8
+    if (rb->bps == 8) { //uint8
         ui8_t u[2*BL];
-        len = fread( u, dsp->bps/8, 2*BL, dsp->fp) / 2;
-        //for (n = 0; n < len; n++) dsp->thd->blk[n] = (u[2*n]-128)/128.0 + I*(u[2*n+1]-128)/128.0;
+        len = fread( u, rb->bps/8, 2*BL, rb->fp) / 2;
+        //for (n = 0; n < len; n++) blk[n] = (u[2*n]-128)/128.0 + I*(u[2*n+1]-128)/128.0;
         // u8: 0..255, 128 -> 0V
         for (n = 0; n < len; n++) {
             x = (u[2*n  ]-128)/128.0;
             y = (u[2*n+1]-128)/128.0;
-            dsp->thd->blk[n] = (x-IQdc.avgIQx) + I*(y-IQdc.avgIQy);
+            blk[n] = (x-IQdc.avgIQx) + I*(y-IQdc.avgIQy);
             IQdc.sumIQx += x;
             IQdc.sumIQy += y;
             IQdc.cnt += 1;
@@ -545,13 +606,13 @@ static int f32_cblk(dsp_t *dsp) {
             }
         }
     }
-    else if (dsp->bps == 16) { //int16
+    else if (rb->bps == 16) { //int16
         short b[2*BL];
-        len = fread( b, dsp->bps/8, 2*BL, dsp->fp) / 2;
+        len = fread( b, rb->bps/8, 2*BL, rb->fp) / 2;
         for (n = 0; n < len; n++) {
             x = b[2*n  ]/32768.0;
             y = b[2*n+1]/32768.0;
-            dsp->thd->blk[n] = (x-IQdc.avgIQx) + I*(y-IQdc.avgIQy);
+            blk[n] = (x-IQdc.avgIQx) + I*(y-IQdc.avgIQy);
             IQdc.sumIQx += x;
             IQdc.sumIQy += y;
             IQdc.cnt += 1;
@@ -563,13 +624,13 @@ static int f32_cblk(dsp_t *dsp) {
             }
         }
     }
-    else { // dsp->bps == 32   //float32
+    else { // rb->bps == 32   //float32
         float f[2*BL];
-        len = fread( f, dsp->bps/8, 2*BL, dsp->fp) / 2;
+        len = fread( f, rb->bps/8, 2*BL, rb->fp) / 2;
         for (n = 0; n < len; n++) {
             x = f[2*n];
             y = f[2*n+1];
-            dsp->thd->blk[n] = (x-IQdc.avgIQx) + I*(y-IQdc.avgIQy);
+            blk[n] = (x-IQdc.avgIQx) + I*(y-IQdc.avgIQy);
             IQdc.sumIQx += x;
             IQdc.sumIQy += y;
             IQdc.cnt += 1;
@@ -581,61 +642,638 @@ static int f32_cblk(dsp_t *dsp) {
             }
         }
     }
-    if (len < BL) bufeof = 1;
 
     return len;
 }
-static int f32read_cblock(dsp_t *dsp) { // blk_cond
 
-    int n;
-    int len = dsp->decM;
+// polyphase sums, M bins, decimation D=M/2 (2x oversampled channels)
+// xbuf[L-1+j] = x[j], output step s at t=s*D+D-1:
+//   u[q] = sum_m h[m*M+M-1-q] * x[t-m*M-(M-1-q)]
+// y_k(t) = sum_q u[q] exp(2pi*I*k*(M-1-q-t)/M) = x*exp(-2pi*I*k*t/M) lowpass h
+static void pfb_block(ring_t *rb, float complex *blk, int len) {
+
+    int j, m, q, s;
+    int M = rb->pfb_M, L = rb->pfb_L;
+    int D = M/2, K = L/M;
+    int BL = rb->blk_len;
+    float *xre = rb->pfb_xre + L-1;
+    float *xim = rb->pfb_xim + L-1;
+    float *hr, *x0re, *x0im, *ure, *uim;
+
+    for (j = 0; j < len; j++) {
+        xre[j] = crealf(rb->pfb_x[j]);
+        xim[j] = cimagf(rb->pfb_x[j]);
+    }
+    for (j = len; j < BL; j++) { xre[j] = 0; xim[j] = 0; }
+
+    for (s = 0; s < BL/D; s++) {
+        ure = (float *)(blk + s*M);
+        uim = ure + M;
+        for (q = 0; q < M; q++) { ure[q] = 0; uim[q] = 0; }
+        for (m = 0; m < K; m++) {
+            hr = rb->pfb_hr + m*M;
+            x0re = rb->pfb_xre + s*D+D-1 + (K-1-m)*M;
+            x0im = rb->pfb_xim + s*D+D-1 + (K-1-m)*M;
+            for (q = 0; q < M; q++) {
+                ure[q] += hr[q] * x0re[q];
+                uim[q] += hr[q] * x0im[q];
+            }
+        }
+    }
 
-    if (bufeof) return 0;
-    //if (dsp->thd->used == 0) { }
+    memmove(rb->pfb_xre, rb->pfb_xre + BL, (L-1)*sizeof(float));
+    memmove(rb->pfb_xim, rb->pfb_xim + BL, (L-1)*sizeof(float));
+}
 
-    pthread_mutex_lock( dsp->thd->mutex );
+void *thd_ring(void *targs) {
+    ring_t *rb = (ring_t *)targs;
+    ring_cons_t *c, **cons;
+    ui32_t w = 0;
+    int k, n, nc, st, full, spin;
+    int slot, len;
 
-    if (rbf == 0)
+    while ( 1 )
     {
-        len = f32_cblk(dsp);
+        spin = 0;
+        while ( 1 ) {
+            if ( atomic_load(&rb->stop) ) goto exit_ring;
+            n = 0;
+            full = 0;
+            nc = atomic_load_explicit(&rb->nc, memory_order_acquire);
+            cons = atomic_load_explicit(&rb->cons, memory_order_acquire);
+            for (k = 0; k < nc; k++) {
+                c = cons[k];
+                st = atomic_load_explicit(&c->state, memory_order_acquire);
+                if (st == RING_JOIN) { // start at next block
+                    atomic_store_explicit(&c->rd, w, memory_order_relaxed);
+                    atomic_store_explicit(&c->state, RING_ACTIVE, memory_order_release);
+                    st = RING_ACTIVE;
+                }
+                if (st == RING_ACTIVE) {
+                    n += 1;
+                    if ( !rb->opt_drop && w - atomic_load_explicit(&c->rd, memory_order_acquire) >= rb->depth ) {
+                        if (spin == 0) c->wait += 1;
+                        full = 1;
+                    }
+                }
+            }
+            if (n > 0 && !full) break;
+            ring_pause(&spin);
+        }
+
+        slot = w % rb->depth;
+        atomic_store_explicit(rb->seq+slot, ~0u, memory_order_relaxed);
+        atomic_thread_fence(memory_order_release);
 
-        rbf = rbf1; // set all bits
-        pthread_cond_broadcast( dsp->thd->cond );
+        if (rb->opt_pfb) {
+            len = f32_cblk(rb, rb->pfb_x);
+            pfb_block(rb, rb->blk + slot*rb->slot_len, len);
+        }
+        else {
+            len = f32_cblk(rb, rb->blk + slot*rb->slot_len);
+        }
+        rb->len[slot] = len;
+
+        atomic_store_explicit(rb->seq+slot, w, memory_order_release);
+        w += 1;
+        atomic_store_explicit(&rb->wr, w, memory_order_release);
+
+        if (len < rb->blk_len) break;
+    }
+
+exit_ring:
+    atomic_store(&rb->eof, 1);
+    bufeof = 1;
+
+    return NULL;
+}
+
+// pool worker: back to scheduler; else (own thread) spin/sleep
+static void thd_yield(thd_t *thd, int *spin) {
+    pool_wk_t *wk = thd->wk;
+    if (wk) swapcontext(&thd->uc, &wk->uc);
+    else    ring_pause(spin);
+}
+
+static int f32read_cblock(dsp_t *dsp) {
+
+    ring_t *rb = dsp->thd->ring;
+    ring_cons_t *c = ring_cons(rb, dsp->thd->tn);
+    ui32_t r, w;
+    int n, n0, len;
+    int slot, spin = 0;
+    int step = dsp->opt_pfb ? dsp->pfb_M : dsp->decM;
+    float sg;
+
+    while (atomic_load_explicit(&c->state, memory_order_acquire) != RING_ACTIVE) {
+        if ( atomic_load(&rb->eof) ) return 0;
+        thd_yield(dsp->thd, &spin);
     }
 
-    while ((rbf & dsp->thd->tn_bit) == 0) pthread_cond_wait( dsp->thd->cond, dsp->thd->mutex );
+    r = atomic_load_explicit(&c->rd, memory_order_relaxed);
+
+    while ( 1 ) {
+        spin = 0;
+        while ( (w = atomic_load_explicit(&rb->wr, memory_order_acquire)) == r ) {
+            if ( atomic_load(&rb->eof) ) return 0;
+            thd_yield(dsp->thd, &spin);
+        }
+        if (rb->opt_drop && w - r >= rb->depth) { // overrun
+            c->drop += w - rb->depth + 1 - r;
+            r = w - rb->depth + 1;
+            dsp->blk_cnt = 0;
+            atomic_store_explicit(&c->rd, r, memory_order_release);
+        }
+
+        slot = r % rb->depth;
+        n0 = dsp->decM*dsp->blk_cnt;
+        len = rb->len[slot] - n0;
+        if (len > dsp->decM) len = dsp->decM;
+        if (dsp->opt_pfb) {
+            sg = (dsp->pfb_k & dsp->blk_cnt & 1) ? -1.0f : 1.0f; // exp(-pi*I*k*n), BLK_SZ even
+            n0 = step*dsp->blk_cnt;
+            for (n = 0; n < step; n++) dsp->decMbuf[n] = sg * rb->blk[slot*rb->slot_len + n0 + n];
+        }
+        else {
+            for (n = 0; n < len; n++) dsp->decMbuf[n] = rb->blk[slot*rb->slot_len + n0 + n];
+        }
 
-    for (n = 0; n < dsp->decM; n++) dsp->decMbuf[n] = dsp->thd->blk[dsp->decM*dsp->blk_cnt + n];
+        if (rb->opt_drop) {
+            atomic_thread_fence(memory_order_acquire);
+            if (atomic_load_explicit(rb->seq+slot, memory_order_relaxed) != r) continue;
+        }
+        break;
+    }
 
     dsp->blk_cnt += 1;
-    if (dsp->blk_cnt == blk_sz) {
-        rbf &= ~(dsp->thd->tn_bit); // clear bit(tn)
+    if (dsp->blk_cnt == BLK_SZ) {
         dsp->blk_cnt = 0;
+        atomic_store_explicit(&c->rd, r+1, memory_order_release); // release slot
+        dsp->thd->busy = 1;
+        if (dsp->thd->wk) thd_yield(dsp->thd, &spin); // next channel
     }
 
-    pthread_mutex_unlock( dsp->thd->mutex );
-
     return len;
 }
 
 int reset_blockread(dsp_t *dsp) {
 
-    int len = 0;
+    ring_leave(dsp->thd->ring, dsp->thd->tn);
+    dsp->blk_cnt = 0;
+
+    return 0;
+}
+
+ring_cons_t *ring_cons(ring_t *rb, int tn) {
+    return atomic_load_explicit(&rb->cons, memory_order_acquire)[tn];
+}
+
+// only main thread: new table, old entries keep their address
+static int ring_grow(ring_t *rb, int nc) {
+
+    int k, n = atomic_load(&rb->nc);
+    ring_cons_t **cons = atomic_load(&rb->cons);
+    ring_cons_t **tab;
+
+    if (nc <= n) return 0;
+    if (nc < 2*n) nc = 2*n;
+    if (rb->n_old >= 32) return -1;
+
+    tab = calloc(nc, sizeof(ring_cons_t *));  if (tab == NULL) return -1;
+    for (k = 0; k < n; k++) tab[k] = cons[k];
+    for (k = n; k < nc; k++) {
+        tab[k] = calloc(1, sizeof(ring_cons_t));  if (tab[k] == NULL) return -1;
+        atomic_init(&tab[k]->rd, 0);
+        atomic_init(&tab[k]->state, RING_OFF);
+    }
+    if (cons) rb->cons_old[rb->n_old++] = cons;
+    atomic_store_explicit(&rb->cons, tab, memory_order_release);
+    atomic_store_explicit(&rb->nc, nc, memory_order_release);
+
+    return 0;
+}
+
+int ring_join(ring_t *rb, int tn) {
+
+    ring_cons_t *c;
+
+    if (tn < 0) return -1;
+    if (tn >= atomic_load(&rb->nc)) {
+        if (ring_grow(rb, tn+1) < 0) return -1;
+    }
+    c = ring_cons(rb, tn);
+    c->drop = 0;
+    c->wait = 0;
+    atomic_store_explicit(&c->state, RING_JOIN, memory_order_release);
+
+    return 0;
+}
+
+// reader skips tn, ring not held back
+int ring_leave(ring_t *rb, int tn) {
+
+    ring_cons_t *c;
+
+    if (tn < 0 || tn >= atomic_load(&rb->nc)) return -1;
+    c = ring_cons(rb, tn);
+    atomic_store_explicit(&c->state, RING_OFF, memory_order_release);
+
+    return 0;
+}
+
+static int lowpass_init(float f, int taps, float **pws);
+
+int ring_init(ring_t *rb, pcm_t *pcm, int depth, int opt_drop) {
+
+    int k, m, q;
+
+    memset(rb, 0, sizeof(ring_t));
+
+    if (depth < 2) depth = 2;
+    rb->fp = pcm->fp;
+    rb->bps = pcm->bps;
+    rb->blk_len = pcm->decM * BLK_SZ;
+    rb->depth = depth;
+    rb->opt_drop = opt_drop;
+    rb->slot_len = rb->blk_len;
+
+    if (pcm->opt_pfb && pcm->decM > 1) {
+        float *h = NULL;
+        int M = 2*pcm->decM;
+        int L = PFB_K*M;
+
+        rb->opt_pfb = 1;
+        rb->pfb_M = M;
+        rb->pfb_L = L;
+        rb->slot_len = BLK_SZ*M; // re[M],im[M] per output sample
+
+        // prototype: cutoff +/- sr_base/M, L-1 taps (odd) + 0
+        if (lowpass_init(1.0/M, L-1, &h) < 0) return -1;
+        rb->pfb_hr = calloc(L+1, sizeof(float));  if (rb->pfb_hr == NULL) return -1;
+        for (m = 0; m < PFB_K; m++) {
+            for (q = 0; q < M; q++) {
+                k = m*M+M-1-q;
+                rb->pfb_hr[m*M+q] = (k < L-1) ? h[k] : 0.0f;
+            }
+        }
+        free(h);
+
+        rb->pfb_xre = calloc(L-1+rb->blk_len+1, sizeof(float));  if (rb->pfb_xre == NULL) return -1;
+        rb->pfb_xim = calloc(L-1+rb->blk_len+1, sizeof(float));  if (rb->pfb_xim == NULL) return -1;
+        rb->pfb_x = calloc(rb->blk_len+1, sizeof(float complex));  if (rb->pfb_x == NULL) return -1;
+    }
+
+    rb->blk = calloc(depth*rb->slot_len+1, sizeof(float complex));  if (rb->blk == NULL) return -1;
+    rb->len = calloc(depth, sizeof(int));  if (rb->len == NULL) return -1;
+    rb->seq = calloc(depth, sizeof(atomic_uint));  if (rb->seq == NULL) return -1;
 
-    pthread_mutex_lock( dsp->thd->mutex );
+    for (k = 0; k < depth; k++) atomic_init(rb->seq+k, ~0u);
+    atomic_init(&rb->nc, 0);
+    atomic_init(&rb->cons, NULL);
+    if (ring_grow(rb, 8) < 0) return -1;
+    atomic_init(&rb->wr, 0);
+    atomic_init(&rb->eof, 0);
+    atomic_init(&rb->stop, 0);
 
-    rbf1 &= ~(dsp->thd->tn_bit);
+    return 0;
+}
+
+int ring_free(ring_t *rb) {
+
+    int k;
+    int nc = atomic_load(&rb->nc);
+    ring_cons_t **cons = atomic_load(&rb->cons);
+
+    if (rb->blk)  { free(rb->blk);  rb->blk  = NULL; }
+    if (rb->len)  { free(rb->len);  rb->len  = NULL; }
+    if (rb->seq)  { free(rb->seq);  rb->seq  = NULL; }
+    if (rb->pfb_hr)  { free(rb->pfb_hr);  rb->pfb_hr  = NULL; }
+    if (rb->pfb_xre) { free(rb->pfb_xre); rb->pfb_xre = NULL; }
+    if (rb->pfb_xim) { free(rb->pfb_xim); rb->pfb_xim = NULL; }
+    if (rb->pfb_x)   { free(rb->pfb_x);   rb->pfb_x   = NULL; }
+    if (cons) {
+        for (k = 0; k < nc; k++) free(cons[k]);
+        free(cons);
+        atomic_store(&rb->cons, NULL);
+        atomic_store(&rb->nc, 0);
+    }
+    for (k = 0; k < rb->n_old; k++) free(rb->cons_old[k]);
+    rb->n_old = 0;
 
-    if ( (rbf & dsp->thd->tn_bit) == dsp->thd->tn_bit )
+    return 0;
+}
+
+
+// worker pool
+//
+// channels (decoder functions thd_rs41() etc.) run as coroutines (ucontext)
+// on a fixed number of worker threads; a channel stays on its worker and
+// yields in f32read_cblock() after each block or if no data is available.
+
+static void ch_entry(unsigned int lo, unsigned int hi) {
+    thd_t *thd = (thd_t *)(uintptr_t)(((unsigned long long)hi << 32) | lo);
+
+    thd->fn(thd->arg);
+    atomic_store(&thd->state, CH_DONE);
+    // uc_link -> worker
+}
+
+// getcontext() returns twice: not in thd_pool(), locals there stay in registers
+static __attribute__((noinline)) void ch_start(pool_wk_t *wk, thd_t *thd) {
+    uintptr_t p = (uintptr_t)thd;
+
+    getcontext(&thd->uc);
+    thd->uc.uc_stack.ss_sp = thd->stack;
+    thd->uc.uc_stack.ss_size = CH_STACK;
+    thd->uc.uc_link = &wk->uc;
+    makecontext(&thd->uc, (void (*)(void))ch_entry, 2,
+                (unsigned int)(p & 0xFFFFFFFF), (unsigned int)((unsigned long long)p >> 32));
+    atomic_store(&thd->state, CH_RUN);
+}
+
+static void *thd_pool(void *targs) {
+    pool_wk_t *wk = (pool_wk_t *)targs;
+    thd_t *thd;
+    int k, busy;
+    int spin = 0;
+
+    while ( 1 )
     {
-        len = f32_cblk(dsp);
+        if ( atomic_load_explicit(&wk->pending, memory_order_acquire) ) {
+            pthread_mutex_lock( &wk->lock );
+            if (wk->n + wk->n_add > wk->cap) {
+                thd_t **ch = realloc(wk->ch, (wk->n + wk->n_add)*sizeof(thd_t *));
+                if (ch) { wk->ch = ch; wk->cap = wk->n + wk->n_add; }
+            }
+            for (k = 0; k < wk->n_add && wk->n < wk->cap; k++) wk->ch[wk->n++] = wk->add[k];
+            // no room (realloc failed): rest stays pending, next loop
+            if (k < wk->n_add) memmove(wk->add, wk->add+k, (wk->n_add-k)*sizeof(thd_t *));
+            wk->n_add -= k;
+            atomic_store(&wk->pending, wk->n_add > 0);
+            pthread_mutex_unlock( &wk->lock );
+        }
+
+        busy = 0;
+        for (k = 0; k < wk->n; k++) {
+            thd = wk->ch[k];
+            if (atomic_load(&thd->state) == CH_NEW) ch_start(wk, thd);
+            thd->busy = 0;
+            swapcontext(&wk->uc, &thd->uc);
+            busy |= thd->busy;
+
+            if (atomic_load(&thd->state) == CH_DONE) {
+                free(thd->stack); thd->stack = NULL;
+                wk->ch[k] = wk->ch[--wk->n]; k--;
+                atomic_fetch_sub(&wk->load, 1);
+                atomic_store(&thd->state, CH_OFF); // slot free
+                busy = 1;
+            }
+        }
 
-        rbf = rbf1; // set all bits
-        pthread_cond_broadcast( dsp->thd->cond );
+        if (wk->n == 0 && atomic_load(wk->stop) && !atomic_load(&wk->pending)) break;
+
+        if (busy) spin = 0;
+        else ring_pause(&spin);
     }
-    pthread_mutex_unlock( dsp->thd->mutex );
 
-    return len;
+    return NULL;
+}
+
+int pool_init(pool_t *pool, int nw) {
+
+    int k;
+
+    if (nw < 1) nw = sysconf(_SC_NPROCESSORS_ONLN);
+    if (nw < 1) nw = 1;
+
+    pool->nw = nw;
+    atomic_init(&pool->stop, 0);
+    pool->wk = calloc(nw, sizeof(pool_wk_t));  if (pool->wk == NULL) return -1;
+
+    for (k = 0; k < nw; k++) {
+        pool_wk_t *wk = pool->wk + k;
+        pthread_mutex_init( &wk->lock, NULL );
+        atomic_init(&wk->pending, 0);
+        atomic_init(&wk->load, 0);
+        wk->stop = &pool->stop;
+        if (pthread_create(&wk->tid, NULL, thd_pool, wk) != 0) return -1;
+    }
+
+    return nw;
+}
+
+// channel -> least loaded worker
+int pool_add(pool_t *pool, thd_t *thd, void *(*fn)(void *), void *arg) {
+
+    int k, j = 0;
+    pool_wk_t *wk;
+
+    for (k = 1; k < pool->nw; k++) {
+        if (atomic_load(&pool->wk[k].load) < atomic_load(&pool->wk[j].load)) j = k;
+    }
+    wk = pool->wk + j;
+
+    thd->stack = malloc(CH_STACK);  if (thd->stack == NULL) return -1;
+
+    pthread_mutex_lock( &wk->lock );
+    if (wk->n_add == wk->cap_add) {
+        int cap = wk->cap_add ? 2*wk->cap_add : 8;
+        thd_t **add = realloc(wk->add, cap*sizeof(thd_t *));
+        if (add == NULL) {  // thd untouched (CH_OFF), caller: ring_leave()
+            pthread_mutex_unlock( &wk->lock );
+            free(thd->stack); thd->stack = NULL;
+            return -1;
+        }
+        wk->add = add;
+        wk->cap_add = cap;
+    }
+    thd->fn = fn;
+    thd->arg = arg;
+    thd->wk = wk;
+    atomic_store(&thd->state, CH_NEW);
+    atomic_fetch_add(&wk->load, 1);
+    wk->add[wk->n_add++] = thd;
+    atomic_store(&wk->pending, 1);
+    pthread_mutex_unlock( &wk->lock );
+
+    return j;
+}
+
+// wait until all channels are done
+int pool_join(pool_t *pool) {
+
+    int k;
+
+    atomic_store(&pool->stop, 1);
+    for (k = 0; k < pool->nw; k++) {
+        pool_wk_t *wk = pool->wk + k;
+        pthread_join(wk->tid, NULL);
+        pthread_mutex_destroy( &wk->lock );
+        if (wk->ch)  { free(wk->ch);  wk->ch  = NULL; }
+        if (wk->add) { free(wk->add); wk->add = NULL; }
+    }
+    free(pool->wk); pool->wk = NULL;
+
+    return 0;
+}
+
+
+// carrier scanner
+//
+// channel like the decoders, reads the undecimated IQ blocks (no pfb);
+// per SCAN_SEC: SCAN_NFFT Hann windowed N-point FFTs averaged,
+// noise floor = median, carrier = run of bins above floor+thres (smoothed
+// over +/-SCAN_BW/2), frequency = power centroid of the run
+
+#define SCAN_SEC   1      // sec per spectrum
+#define SCAN_NFFT  64     // FFTs per spectrum
+#define SCAN_RES   1000   // Hz, max bin width
+#define SCAN_BW    6000   // Hz, smoothing
+
+static int cmp_float(const void *a, const void *b) {
+    float x = *(const float *)a, y = *(const float *)b;
+    return (x > y) - (x < y);
+}
+
+static int scan_carriers(dft_t *dft, float *ps, float *tmp, scan_t *sc) {
+    int N = dft->N;
+    int W = (SCAN_BW/2) * N / dft->sr;
+    int i, j, n = 0;
+    double sum, fl, lim;
+    double fq[SCAN_MAXCAR];
+    float db[SCAN_MAXCAR];
+
+    for (i = 0; i < N; i++) tmp[i] = ps[i];
+    qsort(tmp, N, sizeof(float), cmp_float);
+    fl = tmp[N/2];
+    if (fl <= 0) return 0;
+    lim = fl * pow(10.0, sc->thres/10.0);
+
+    ps[N/2-1] = ps[N/2] = ps[N/2+1] = fl; // DC
+
+    // moving average +/-W
+    sum = 0;
+    for (i = 0; i < W && i < N; i++) sum += ps[i];
+    for (i = 0; i < N; i++) {
+        if (i+W < N) sum += ps[i+W];
+        if (i-W-1 >= 0) sum -= ps[i-W-1];
+        tmp[i] = sum / (double)(2*W+1);
+    }
+
+    i = 0;
+    while (i < N && n < SCAN_MAXCAR) {
+        double s0 = 0, s1 = 0, mx = 0;
+        if (tmp[i] <= lim) { i++; continue; }
+        for (j = i; j < N && tmp[j] > lim; j++) {
+            double p = ps[j] - fl;
+            if (p > 0) { s0 += p; s1 += p*j; }
+            if (tmp[j] > mx) mx = tmp[j];
+        }
+        if (s0 > 0 && i > 0 && j < N) { // not at band edge
+            fq[n] = (s1/s0 - N/2) / (double)N;
+            db[n] = 10.0*log10(mx/fl);
+            n++;
+        }
+        i = j;
+    }
+
+    pthread_mutex_lock( &sc->lock );
+    for (i = 0; i < n; i++) { sc->fq[i] = fq[i]; sc->db[i] = db[i]; }
+    sc->n = n;
+    sc->seq += 1;
+    pthread_mutex_unlock( &sc->lock );
+
+    return n;
+}
+
+void *thd_scan(void *targs) {
+
+    thargs_t *tharg = targs;
+    pcm_t *pcm = &(tharg->pcm);
+    scan_t *sc = tharg->scan;
+    dsp_t dsp = {0};
+    dft_t dft = {0};
+    float complex *x = NULL;
+    float *pw = NULL, *ps = NULL, *tmp = NULL;
+    int N, log2n = 6;
+    int n, k, len;
+    int step, per, cnt, s, nfft, spin;
+
+    dsp.thd = &(tharg->thd);
+    dsp.decM = pcm->decM;
+    dsp.opt_pfb = 0;
+    dsp.decMbuf = calloc(dsp.decM+1, sizeof(float complex));  if (dsp.decMbuf == NULL) goto exit_thread;
+
+    while ((pcm->sr_base >> log2n) > SCAN_RES && log2n < 16) log2n++;
+    N = 1 << log2n;
+    dft.N = N;
+    dft.N2 = N;
+    dft.LOG2N = log2n;
+    dft.sr = pcm->sr_base;
+    dft.win = calloc(N+1, sizeof(float complex));  if (dft.win == NULL) goto exit_thread;
+    dft_window(&dft, 1);
+    dft.brv = calloc(N+1, sizeof(int));  if (dft.brv == NULL) goto exit_thread;
+    dft.tw  = calloc(N+1, sizeof(float complex));  if (dft.tw == NULL) goto exit_thread;
+    dft_tables(&dft);
+
+    x   = calloc(N+1, sizeof(float complex));  if (x   == NULL) goto exit_thread;
+    pw  = calloc(N+1, sizeof(float));  if (pw  == NULL) goto exit_thread;
+    ps  = calloc(N+1, sizeof(float));  if (ps  == NULL) goto exit_thread;
+    tmp = calloc(N+1, sizeof(float));  if (tmp == NULL) goto exit_thread;
+
+    // FFT every step samples
+    step = pcm->sr_base*SCAN_SEC / SCAN_NFFT;
+    if (step < N) step = N;
+    per = step*SCAN_NFFT;
+
+    fprintf(stderr, "scan: N=%d (%.1f Hz), %d FFTs/%ds\n", N, pcm->sr_base/(float)N, SCAN_NFFT, SCAN_SEC);
+
+    cnt = 0;
+    nfft = 0;
+    while ( (len = f32read_cblock(&dsp)) > 0 )
+    {
+        if (dsp.thd->used == 0) break;
+
+        for (n = 0; n < len; n++) {
+            s = cnt % step;
+            if (s < N) {
+                x[s] = dsp.decMbuf[n] * crealf(dft.win[s]);
+                if (s == N-1) {
+                    raw_dft(&dft, x);
+                    for (k = 0; k < N; k++) pw[k] += crealf(x[k])*crealf(x[k]) + cimagf(x[k])*cimagf(x[k]);
+                    nfft += 1;
+                }
+            }
+            cnt += 1;
+            if (cnt == per) {
+                // -0.5 .. 0.5
+                for (k = 0; k < N; k++) ps[k] = pw[(k + N/2) % N] / (float)nfft;
+                scan_carriers(&dft, ps, tmp, sc);
+                // wait for main thread (holds ring, probes join at this block)
+                spin = 0;
+                while ( dsp.thd->used && !atomic_load(&dsp.thd->ring->eof)
+                        && atomic_load(&sc->ack) != atomic_load(&sc->seq) ) thd_yield(dsp.thd, &spin);
+                memset(pw, 0, N*sizeof(float));
+                nfft = 0;
+                cnt = 0;
+            }
+        }
+    }
+
+exit_thread:
+    if (x)   free(x);
+    if (pw)  free(pw);
+    if (ps)  free(ps);
+    if (tmp) free(tmp);
+    if (dft.win) free(dft.win);
+    if (dft.brv) free(dft.brv);
+    if (dft.tw)  free(dft.tw);
+    if (dsp.decMbuf) free(dsp.decMbuf);
+
+    reset_blockread(&dsp);
+    (dsp.thd)->used = 0;
+
+    return NULL;
 }
 
 // decimate lowpass
@@ -726,6 +1364,52 @@ static float complex lowpass(float complex buffer[], ui32_t sample, ui32_t taps,
 // symmetry: ws[n] == ws[taps-1-n]
 }
 
+// decimate: linear delay line xre/xim[0..2*taps-1], x[n] == x[n+taps],
+// window x[s+1..s+taps] contiguous (same order as lowpass()), no wrap/modulo;
+// separate re/im arrays -> packed float (SSE/AVX/NEON via -Ofast autovectorization),
+// x86-64: avx2/default clones, selected at load time
+#if defined(__GNUC__) && defined(__x86_64__) && defined(__linux__)
+  #define DEC_VEC __attribute__((target_clones("avx2","default")))
+#else
+  #define DEC_VEC
+#endif
+DEC_VEC
+static float complex lowpass_vec(float *xre, float *xim, ui32_t sample, ui32_t taps, float *ws) {
+    float *restrict xr = xre + sample+1;
+    float *restrict xi = xim + sample+1;
+    float wr = 0, wi = 0;  // -Ofast
+    int n;
+    for (n = 0; n < taps; n++) {
+        wr += xr[n]*ws[n];
+        wi += xi[n]*ws[n];
+    }
+    return wr + I*wi;
+}
+DEC_VEC
+static void mix_decX(dsp_t *dsp) {
+    ui32_t T = dsp->dectaps;
+    int j = 0;
+    while (j < dsp->decM) {
+        float complex *restrict zb = dsp->decMbuf + j;
+        float complex *restrict ex = dsp->ex + dsp->sample_decM;
+        float *restrict xr = dsp->decXre + dsp->sample_decX;
+        float *restrict xi = dsp->decXim + dsp->sample_decX;
+        int run = dsp->decM - j;
+        int n;
+        if (run > dsp->lut_len - dsp->sample_decM) run = dsp->lut_len - dsp->sample_decM;
+        if (run > T - dsp->sample_decX) run = T - dsp->sample_decX;
+        for (n = 0; n < run; n++) {
+            float complex z = zb[n] * ex[n];
+            xr[n] = xr[n+T] = crealf(z);
+            xi[n] = xi[n+T] = cimagf(z);
+        }
+        j += run;
+        dsp->sample_decM += run; if (dsp->sample_decM >= dsp->lut_len) dsp->sample_decM = 0;
+        dsp->sample_decX += run; if (dsp->sample_decX >= T) dsp->sample_decX = 0;
+    }
+}
+
+
 static float re_lowpass0(float buffer[], ui32_t sample, ui32_t taps, float *ws) {
     ui32_t n;
     double w = 0;
@@ -745,6 +1429,68 @@ static float re_lowpass(float buffer[], ui32_t sample, ui32_t taps, float *ws) {
 }
 
 
+// channelizer: bin k, then residual offset (2*Hz) at output rate sr
+static float complex pfb_bin(dsp_t *dsp) {
+    int q, M = dsp->pfb_M;
+    float *ure = (float *)dsp->decMbuf;
+    float *uim = ure + M;
+    float *twr = dsp->pfb_tw;
+    float *twi = twr + M;
+    float yr = 0, yi = 0;
+    long long p;
+
+    for (q = 0; q < M; q++) {
+        yr += ure[q]*twr[q] - uim[q]*twi[q];
+        yi += ure[q]*twi[q] + uim[q]*twr[q];
+    }
+
+    if ((dsp->pfb_n & 0xFF) == 0) { // re-sync phasor
+        p = (dsp->pfb_h2 * (long long)dsp->pfb_n) % (2LL*dsp->sr);
+        dsp->pfb_w = cexp(p*M_PI/(double)dsp->sr*I);
+    }
+    else dsp->pfb_w *= dsp->pfb_dw;
+    dsp->pfb_n += 1; if (dsp->pfb_n >= 2*dsp->sr) dsp->pfb_n = 0;
+
+    return (yr + I*yi) * (float complex)dsp->pfb_w;
+}
+
+// FM discriminator: atan2() polynomial, |err| < 1e-5 rad (Abramowitz/Stegun 4.4.49), no libm
+static inline float atan2_poly(float y, float x) {
+    float ax = fabsf(x), ay = fabsf(y);
+    float mx = ax > ay ? ax : ay;
+    float mn = ax > ay ? ay : ax;
+    float a = mx > 0.0f ? mn/mx : 0.0f;
+    float q = a*a;
+    float r = a*(0.9998660f + q*(-0.3302995f + q*(0.1801410f + q*(-0.0851330f + q*0.0208351f))));
+    r = ay > ax ? (float)(M_PI/2.0) - r : r;
+    r = x < 0.0f ? (float)M_PI - r : r;
+    return y < 0.0f ? -r : r;
+}
+
+// NCO instead of cexp() per sample: z *= w, exact phase at f/n change and every NCO_SEED samples;
+// phase f*n of absolute sample n (as cexp(f*n*2pi*I)), i.e. Df update in find_header() unchanged
+#define NCO_SEED 1024
+
+static void nco_set(nco_t *o, double f, ui32_t n) {
+    double ph = f*(double)n;
+    ph -= floor(ph);
+    o->f = f;
+    o->z = cexp(ph*_2PI*I);
+    o->w = cexp(f*_2PI*I);
+    o->n = n;
+    o->k = 0;
+}
+
+static double complex nco_exp(nco_t *o, double f, ui32_t n) {
+    double complex z;
+    if (f != o->f || n != o->n || o->k >= NCO_SEED) nco_set(o, f, n);
+    z = o->z;
+    o->z *= o->w;
+    o->n += 1;
+    o->k += 1;
+    return z;
+}
+
 int f32buf_sample(dsp_t *dsp, int inv) {
     float s = 0.0;
     float xneu, xalt;
@@ -760,23 +1506,38 @@ int f32buf_sample(dsp_t *dsp, int inv) {
             //ui32_t s_reset = dsp->dectaps*dsp->lut_len;
             int j;
             if ( f32read_cblock(dsp) < dsp->decM ) return EOF;
-            //if ( f32read_cblock(dsp) < dsp->decM * blk_sz) return EOF;
-            for (j = 0; j < dsp->decM; j++) {
-                z = dsp->decMbuf[j] * dsp->ex[dsp->sample_decM];
-                dsp->sample_decM += 1; if (dsp->sample_decM >= dsp->lut_len) dsp->sample_decM = 0;
-                dsp->decXbuffer[dsp->sample_decX] = z;
-                dsp->sample_decX += 1; if (dsp->sample_decX >= dsp->dectaps) dsp->sample_decX = 0;
+            //if ( f32read_cblock(dsp) < dsp->decM * BLK_SZ) return EOF;
+            if (dsp->opt_pfb) {
+                z = pfb_bin(dsp);
+            }
+            else if (dsp->decM > 1 && !dsp->opt_novec) {
+                mix_decX(dsp); // LUT, contiguous runs
+            }
+            else {
+                for (j = 0; j < dsp->decM; j++) {
+                    z = dsp->decMbuf[j] * dsp->ex[dsp->sample_decM];
+                    dsp->sample_decM += 1; if (dsp->sample_decM >= dsp->lut_len) dsp->sample_decM = 0;
+                    if (dsp->opt_novec) {
+                        dsp->decXbuffer[dsp->sample_decX] = z;
+                    }
+                    else {
+                        dsp->decXre[dsp->sample_decX] = dsp->decXre[dsp->sample_decX + dsp->dectaps] = crealf(z);
+                        dsp->decXim[dsp->sample_decX] = dsp->decXim[dsp->sample_decX + dsp->dectaps] = cimagf(z);
+                    }
+                    dsp->sample_decX += 1; if (dsp->sample_decX >= dsp->dectaps) dsp->sample_decX = 0;
+                }
             }
-            if (dsp->decM > 1)
+            if (dsp->decM > 1 && !dsp->opt_pfb)
             {
-                z = lowpass(dsp->decXbuffer, dsp->sample_decX, dsp->dectaps, ws_dec);
+                if (dsp->opt_novec) z = lowpass(dsp->decXbuffer, dsp->sample_decX, dsp->dectaps, ws_dec);
+                else                z = lowpass_vec(dsp->decXre, dsp->decXim, dsp->sample_decX, dsp->dectaps, ws_dec);
             }
         }
         else if ( f32read_csample(dsp, &z) == EOF ) return EOF;
 
         if (dsp->opt_dc)
         {
-            z *= cexp(-t*_2PI*dsp->Df*I);
+            z *= nco_exp(&dsp->nco_dc, -dsp->Df/(double)dsp->sr, dsp->sample_in);
         }
 
 
@@ -789,7 +1550,7 @@ int f32buf_sample(dsp_t *dsp, int inv) {
 
         z0 = dsp->rot_iqbuf[(dsp->sample_in-1 + dsp->N_IQBUF) % dsp->N_IQBUF];
         w = z * conj(z0);
-        s = gain * carg(w)/M_PI;
+        s = gain * atan2_poly(cimagf(w), crealf(w))/M_PI;
 
         dsp->rot_iqbuf[dsp->sample_in % dsp->N_IQBUF] = z;
 
@@ -810,24 +1571,21 @@ int f32buf_sample(dsp_t *dsp, int inv) {
             //double f1 = -dsp->h*dsp->sr/(2*dsp->sps);
             //double f2 = -f1;
 
-            float complex X0 = 0;
-            float complex X  = 0;
+            double complex e1, e2;
 
             int n = dsp->sps;
-            double tn = (dsp->sample_in-n) / (double)dsp->sr;
             //t = dsp->sample_in / (double)dsp->sr;
             //z = dsp->rot_iqbuf[dsp->sample_in % dsp->N_IQBUF];
             z0 = dsp->rot_iqbuf[(dsp->sample_in-n + dsp->N_IQBUF) % dsp->N_IQBUF];
 
+            // X = z*exp(-t*iw), X0 = z0*exp(-tn*iw) = z0*exp(-t*iw)*dw
             // f1
-            X0 = z0 * cexp(-tn*dsp->iw1); // alt
-            X  = z  * cexp(-t *dsp->iw1); // neu
-            dsp->F1sum +=  X - X0;
+            e1 = nco_exp(&dsp->nco_f1, dsp->nco_f1.f, dsp->sample_in);
+            dsp->F1sum += e1 * (z - z0*dsp->dw1); // neu - alt
 
             // f2
-            X0 = z0 * cexp(-tn*dsp->iw2); // alt
-            X  = z  * cexp(-t *dsp->iw2); // neu
-            dsp->F2sum +=  X - X0;
+            e2 = nco_exp(&dsp->nco_f2, dsp->nco_f2.f, dsp->sample_in);
+            dsp->F2sum += e2 * (z - z0*dsp->dw2); // neu - alt
 
             xbit = cabs(dsp->F2sum) - cabs(dsp->F1sum);
 
@@ -1165,22 +1923,53 @@ int init_buffers(dsp_t *dsp) {
             }
         }
 
-        dsp->lut_len = dsp->sr_base / d;
-        f0 = freq0 / (double)dsp->sr_base;
+        if (dsp->opt_pfb) {
+            // bin spacing sr_base/M = sr/2, residual |freq + k*sr/2| <= sr/4
+            int M = dsp->thd->ring->pfb_M;
+            int D = M/2;
+            int kb = (int)floor(-dsp->thd->xlt_fq*M + 0.5);
+            double h2 = 2.0*freq + kb*(double)dsp->sr;
+
+            dsp->pfb_M = M;
+            dsp->pfb_k = ((kb % M) + M) % M;
+            dsp->pfb_tw = calloc(2*M+1, sizeof(float));
+            if (dsp->pfb_tw == NULL) return -1;
+            for (n = 0; n < M; n++) {
+                t = dsp->pfb_k*(double)(D-n)/(double)M;
+                dsp->pfb_tw[n]   = cos(t*_2PI);
+                dsp->pfb_tw[M+n] = sin(t*_2PI);
+            }
+            dsp->pfb_h2 = (long long)h2;
+            dsp->pfb_n = 0;
+            dsp->pfb_w = 1.0;
+            dsp->pfb_dw = cexp(h2*M_PI/(double)dsp->sr*I);
 
-        dsp->ex = calloc(dsp->lut_len+1, sizeof(float complex));
-        if (dsp->ex == NULL) return -1;
-        for (n = 0; n < dsp->lut_len; n++) {
-            t = f0*(double)n;
-            dsp->ex[n] = cexp(t*_2PI*I);
+            dsp->decMbuf = calloc( M+1, sizeof(float complex));
+            if (dsp->decMbuf == NULL) return -1;
         }
+        else {
+            dsp->lut_len = dsp->sr_base / d;
+            f0 = freq0 / (double)dsp->sr_base;
+
+            dsp->ex = calloc(dsp->lut_len+1, sizeof(float complex));
+            if (dsp->ex == NULL) return -1;
+            for (n = 0; n < dsp->lut_len; n++) {
+                t = f0*(double)n;
+                dsp->ex[n] = cexp(t*_2PI*I);
+            }
+
 
+            dsp->decXbuffer = calloc( dsp->dectaps+1, sizeof(float complex));
+            if (dsp->decXbuffer == NULL) return -1;
 
-        dsp->decXbuffer = calloc( dsp->dectaps+1, sizeof(float complex));
-        if (dsp->decXbuffer == NULL) return -1;
+            dsp->decXre = calloc( 2*dsp->dectaps+1, sizeof(float));
+            if (dsp->decXre == NULL) return -1;
+            dsp->decXim = calloc( 2*dsp->dectaps+1, sizeof(float));
+            if (dsp->decXim == NULL) return -1;
 
-        dsp->decMbuf = calloc( dsp->decM+1, sizeof(float complex));
-        if (dsp->decMbuf == NULL) return -1;
+            dsp->decMbuf = calloc( dsp->decM+1, sizeof(float complex));
+            if (dsp->decMbuf == NULL) return -1;
+        }
     }
 
     if (dsp->opt_iq && dsp->opt_lp)
@@ -1312,6 +2101,10 @@ int init_buffers(dsp_t *dsp) {
         dsp->DFT.ew[n] = cexp(-I*M_PI/(float)k);
     }
 
+    dsp->DFT.brv = calloc(dsp->DFT.N+1, sizeof(int));  if (dsp->DFT.brv == NULL) return -1;
+    dsp->DFT.tw  = calloc(dsp->DFT.N+1, sizeof(float complex));  if (dsp->DFT.tw == NULL) return -1;
+    dft_tables(&dsp->DFT);
+
     m = calloc(dsp->DFT.N+1, sizeof(float));  if (m  == NULL) return -1;
     for (i = 0; i < L; i++) m[L-1 - i] = dsp->match[i]; // t = L-1
     while (i < dsp->DFT.N) m[i++] = 0.0;
@@ -1337,7 +2130,12 @@ int init_buffers(dsp_t *dsp) {
         double f2 = -f1;
         dsp->iw1 = _2PI*I*f1;
         dsp->iw2 = _2PI*I*f2;
+        nco_set(&dsp->nco_f1, -f1/(double)dsp->sr, 0);
+        nco_set(&dsp->nco_f2, -f2/(double)dsp->sr, 0);
+        dsp->dw1 = cexp(dsp->iw1*(int)dsp->sps/(double)dsp->sr);
+        dsp->dw2 = cexp(dsp->iw2*(int)dsp->sps/(double)dsp->sr);
     }
+    nco_set(&dsp->nco_dc, 0.0, 0);
 
     return K;
 }
@@ -1357,6 +2155,8 @@ int free_buffers(dsp_t *dsp) {
     if (dsp->DFT.X)  { free(dsp->DFT.X);  dsp->DFT.X  = NULL; }
     if (dsp->DFT.Z)  { free(dsp->DFT.Z);  dsp->DFT.Z  = NULL; }
     if (dsp->DFT.cx) { free(dsp->DFT.cx); dsp->DFT.cx = NULL; }
+    if (dsp->DFT.brv) { free(dsp->DFT.brv); dsp->DFT.brv = NULL; }
+    if (dsp->DFT.tw) { free(dsp->DFT.tw); dsp->DFT.tw = NULL; }
 
     if (dsp->DFT.win) { free(dsp->DFT.win); dsp->DFT.win = NULL; }
 
@@ -1370,8 +2170,11 @@ int free_buffers(dsp_t *dsp) {
     if (dsp->opt_iq == 5)
     {
         if (dsp->decXbuffer) { free(dsp->decXbuffer); dsp->decXbuffer = NULL; }
+        if (dsp->decXre)     { free(dsp->decXre);     dsp->decXre     = NULL; }
+        if (dsp->decXim)     { free(dsp->decXim);     dsp->decXim     = NULL; }
         if (dsp->decMbuf)    { free(dsp->decMbuf);    dsp->decMbuf    = NULL; }
         if (dsp->ex)         { free(dsp->ex);         dsp->ex         = NULL; }
+        if (dsp->pfb_tw)     { free(dsp->pfb_tw);     dsp->pfb_tw     = NULL; }
 
         // free(ws_dec) -> decimate_free()
     }
@@ -1401,6 +2204,7 @@ ui32_t get_sample(dsp_t *dsp) {
 /* ------------------------------------------------------------------------------------ */
 
 #define SEC_NO_SIGNAL 10
+#define SEC_PROBE      4  // scan: probe channel without header
 
 int find_header(dsp_t *dsp, float thres, int hdmax, int bitofs, int opt_dc) {
     ui32_t k = 0;
@@ -1418,6 +2222,10 @@ int find_header(dsp_t *dsp, float thres, int hdmax, int bitofs, int opt_dc) {
             //if (option_auto == 0 && dsp->mv < 0) mv = 0;
             k = 0;
 
+            // probe: wrong type or no sonde, close quietly
+            if ( dsp->thd->probe &&
+                 (dsp->thd->used == 0 || dsp->sample_in > SEC_PROBE*dsp->sr) ) return EOF;
+
             // signal lost
             if ( dsp->thd->used == 0 ||
                  (!dsp->opt_cnt  &&  dsp->mv_pos - dsp->last_detect > SEC_NO_SIGNAL*dsp->sr) )
@@ -1449,16 +2257,20 @@ int find_header(dsp_t *dsp, float thres, int hdmax, int bitofs, int opt_dc) {
                             float complex X2 = 0;
                             float complex _z = 0;
                             int _n = dsp->sps;
+                            nco_t _r, _e1, _e2;
+                            nco_set(&_r,  -diffDf/(double)dsp->sr, dsp->sample_in - _n);
+                            nco_set(&_e1, dsp->nco_f1.f, dsp->sample_in - _n);
+                            nco_set(&_e2, dsp->nco_f2.f, dsp->sample_in - _n);
                             while ( _n > 0 )
                             {
                                 // update rot_iqbuf
-                                double _tn = (dsp->sample_in - _n) / (double)dsp->sr;
-                                dsp->rot_iqbuf[(dsp->sample_in - _n + dsp->N_IQBUF) % dsp->N_IQBUF] *= cexp(-_tn*_2PI*diffDf*I);
+                                ui32_t _sn = dsp->sample_in - _n;
+                                dsp->rot_iqbuf[(_sn + dsp->N_IQBUF) % dsp->N_IQBUF] *= nco_exp(&_r, _r.f, _sn);
                                 //
                                 //update/reset F1sum, F2sum
-                                _z = dsp->rot_iqbuf[(dsp->sample_in - _n + dsp->N_IQBUF) % dsp->N_IQBUF];
-                                X1 += _z*cexp(-_tn*dsp->iw1);
-                                X2 += _z*cexp(-_tn*dsp->iw2);
+                                _z = dsp->rot_iqbuf[(_sn + dsp->N_IQBUF) % dsp->N_IQBUF];
+                                X1 += _z*nco_exp(&_e1, _e1.f, _sn);
+                                X2 += _z*nco_exp(&_e2, _e2.f, _sn);
                                 _n--;
                             }
                             dsp->F1sum = X1;
@@ -1489,6 +2301,13 @@ int find_header(dsp_t *dsp, float thres, int hdmax, int bitofs, int opt_dc) {
 
                 dsp->last_detect = dsp->mv_pos;
 
+                if (header_found && dsp->thd->probe) {
+                    dsp->thd->probe = 0;
+                    pthread_mutex_lock( dsp->thd->mutex );
+                    fprintf(stdout, "<%d: add f=%+.4f>\n", dsp->thd->tn, -dsp->thd->xlt_fq);
+                    pthread_mutex_unlock( dsp->thd->mutex );
+                }
+
                 if (header_found) return 1;
             }
         }
@@ -5,6 +5,8 @@
 #include <math.h>
 #include <complex.h>
 #include <pthread.h>
+#include <stdatomic.h>
+#include <ucontext.h>
 
 #ifndef M_PI
     #define M_PI  (3.1415926535897932384626433832795)
@@ -17,29 +19,99 @@
 typedef unsigned char  ui8_t;
 typedef unsigned short ui16_t;
 typedef unsigned int   ui32_t;
+typedef unsigned long long ui64_t;
 typedef char  i8_t;
 typedef short i16_t;
 typedef int   i32_t;
 #endif
 
 
-#define MAX_FQ 5
-static int blk_sz = 32; // const
+#define BLK_SZ 32       // IQ block: output samples per block
 
+#define RING_DEPTH 64   // blocks (decM*BLK_SZ IQ samples)
+#define PFB_K 8        // channelizer: prototype taps per bin (L = PFB_K*M)
+
+// IQ block ring: 1 reader thread, consumer threads with own read cursors
+enum { RING_OFF = 0, RING_JOIN, RING_ACTIVE };
 
 typedef struct {
-    int tn;
-    int tn_bit;
+    atomic_uint rd;     // next block
+    atomic_int state;   // RING_OFF/JOIN/ACTIVE; JOIN -> ACTIVE by reader
+    ui32_t drop;        // blocks lost (opt_drop)
+    ui32_t wait;        // reader stalled by this consumer (no opt_drop)
+} ring_cons_t;
+
+typedef struct {
+    FILE *fp;
+    int bps;
+    int blk_len;        // decM*BLK_SZ
+    int depth;
+    int opt_drop;       // don't stall reader, slow consumers skip blocks
+    int slot_len;       // complex samples per slot
+    float complex *blk; // depth*slot_len
+    int *len;           // valid samples per slot
+    atomic_uint *seq;   // block number in slot
+    atomic_uint wr;     // blocks written
+    atomic_int eof;
+    atomic_int stop;
     pthread_t tid;
+    atomic_int nc;                 // consumers (grows, ring_join)
+    _Atomic(ring_cons_t **) cons;  // [nc], entries never move
+    ring_cons_t **cons_old[32];    // replaced tables, free at exit
+    int n_old;
+    // channelizer (opt_pfb): M=2*decM bins, spacing sr_base/M, output sr_base/decM;
+    // slot: per output sample polyphase sums u[M] (re[M],im[M]), DFT bin per channel
+    int opt_pfb;
+    int pfb_M;
+    int pfb_L;          // prototype taps M*K
+    float *pfb_hr;      // hr[m*M+q] = h[m*M+M-1-q]
+    float *pfb_xre;     // history L-1 + blk_len
+    float *pfb_xim;
+    float complex *pfb_x;
+} ring_t;
+
+
+// channel: coroutine on a pool worker, yields in f32read_cblock()
+#define CH_STACK (1<<21)
+enum { CH_OFF = 0, CH_NEW, CH_RUN, CH_DONE };
+
+typedef struct {
+    int tn;
     pthread_mutex_t *mutex;
-    pthread_cond_t *cond;
     //pthread_rwlock_t *lock;
-    int max_fq;
     double xlt_fq;
-    float complex *blk;
+    ring_t *ring;
     int used;
+    int probe;    // scan: no header yet, close after SEC_PROBE
+    //
+    void *(*fn)(void *);
+    void *arg;
+    atomic_int state;  // CH_OFF: slot free
+    int busy;     // consumed data since last yield
+    char *stack;
+    ucontext_t uc;
+    void *wk;     // pool_wk_t
 } thd_t;
 
+typedef struct {
+    pthread_t tid;
+    ucontext_t uc;          // scheduler
+    thd_t **ch;             // own channels, worker only
+    int n, cap;
+    thd_t **add;            // new channels (pool_add)
+    int n_add, cap_add;
+    pthread_mutex_t lock;   // add[]
+    atomic_int pending;
+    atomic_int load;        // channels on this worker
+    atomic_int *stop;
+} pool_wk_t;
+
+typedef struct {
+    int nw;
+    pool_wk_t *wk;
+    atomic_int stop;        // exit when no channels left
+} pool_t;
+
 
 typedef struct {
     int sr;       // sample_rate
@@ -53,9 +125,21 @@ typedef struct {
     float complex  *Z;
     float complex  *cx;
     float complex  *win; // float real
+    int *brv;            // bit-reversal table
+    float complex  *tw;  // twiddles: tw[l2-1+j] = exp(-I*pi*j/l2)
 } dft_t;
 
 
+// NCO: z = exp(2pi*I*f*n), recursive, exact phase every NCO_SEED samples
+typedef struct {
+    double f;           // cycles/sample
+    double complex z;
+    double complex w;   // exp(2pi*I*f)
+    ui32_t n;           // next sample
+    int k;
+} nco_t;
+
+
 typedef struct {
     FILE *fp;
     //
@@ -104,6 +188,10 @@ typedef struct {
     //
     double complex iw1;
     double complex iw2;
+    nco_t nco_f1;       // exp(-t*iw1)
+    nco_t nco_f2;       // exp(-t*iw2)
+    double complex dw1; // exp(sps*iw1/sr): t-sps/sr
+    double complex dw2;
 
 
     //
@@ -124,6 +212,7 @@ typedef struct {
     double dc;
     double Df;
     double dDf;
+    nco_t nco_dc;       // exp(-t*2pi*Df*I)
 
     ui32_t sample_posframe;
     ui32_t sample_posnoise;
@@ -133,6 +222,7 @@ typedef struct {
     double SNRdB;
 
     // decimate
+    int opt_novec; // default: vector decimation lowpass
     int decM;
     int blk_cnt;
     ui32_t sr_base;
@@ -141,9 +231,21 @@ typedef struct {
     ui32_t lut_len;
     ui32_t sample_decM;
     float complex *decXbuffer;
+    float *decXre; // linear delay line 2*dectaps, re/im
+    float *decXim;
     float complex *decMbuf;
     float complex *ex; // exp_lut
 
+    // channelizer bin + fine tune
+    int opt_pfb;
+    int pfb_M;
+    int pfb_k;
+    float *pfb_tw;     // re[M],im[M]: exp(2pi*I*k*(D-q)/M), D=M/2
+    ui32_t pfb_n;      // mod 2*sr
+    long long pfb_h2;  // 2*fine_offset/Hz
+    double complex pfb_w;
+    double complex pfb_dw;
+
     // IF: lowpass
     int opt_lp;
     int lpIQ_bw;
@@ -174,6 +276,8 @@ typedef struct {
     int sel_ch;   // select wav channel
 //
     int opt_IFmin;
+    int opt_novec;
+    int opt_pfb;
     int sr_base;
     int decM;
     int dectaps;
@@ -187,6 +291,21 @@ typedef struct {
 } hsbit_t;
 
 
+// carrier scanner: averaged power spectrum of the IQ stream (ring consumer),
+// carriers above noise floor -> main thread starts probe channels
+#define SCAN_MAXCAR 32
+
+typedef struct {
+    pthread_mutex_t lock;
+    float thres;              // dB above noise floor
+    atomic_int seq;           // spectra (SCAN_SEC each)
+    atomic_int ack;           // seq done by main thread (probes started)
+    int n;                    // carriers in last spectrum
+    double fq[SCAN_MAXCAR];   // fq/sr_base
+    float  db[SCAN_MAXCAR];
+} scan_t;
+
+
 typedef struct {
     pcm_t pcm;
     thd_t thd;
@@ -194,6 +313,7 @@ typedef struct {
     int option_dc;
     int option_cnt;
     int jsn_freq;
+    scan_t *scan;
 } thargs_t;
 
 
@@ -216,4 +336,17 @@ int iq_dc_init(pcm_t *);
 
 int reset_blockread(dsp_t *);
 
+int ring_init(ring_t *, pcm_t *, int, int);
+int ring_free(ring_t *);
+int ring_join(ring_t *, int);
+int ring_leave(ring_t *, int);
+ring_cons_t *ring_cons(ring_t *, int);
+void *thd_ring(void *);
+
+void *thd_scan(void *);
+
+int pool_init(pool_t *, int);
+int pool_add(pool_t *, thd_t *, void *(*)(void *), void *);
+int pool_join(pool_t *);
+
 
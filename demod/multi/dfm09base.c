@@ -166,13 +166,6 @@ static ui8_t G[8][4] =  // Generator
                       { 1, 0, 1, 1},
                       { 1, 1, 0, 1},
                       { 1, 1, 1, 0}};
-static ui8_t H[4][8] =  // Parity-Check
-                     {{ 0, 1, 1, 1, 1, 0, 0, 0},
-                      { 1, 0, 1, 1, 0, 1, 0, 0},
-                      { 1, 1, 0, 1, 0, 0, 1, 0},
-                      { 1, 1, 1, 0, 0, 0, 0, 1}};
-static ui8_t He[8] = { 0x7, 0xB, 0xD, 0xE, 0x8, 0x4, 0x2, 0x1}; // Spalten von H:
-                                                                // 1-bit-error-Syndrome
 
 static ui32_t bits2val(ui8_t *bits, int len) { // big endian
     int j;
@@ -185,56 +178,68 @@ static ui32_t bits2val(ui8_t *bits, int len) { // big endian
     return val;
 }
 
-static void deinterleave(char *str, int L, ui8_t *block) {
+// Hamming(8,4) hard decision, Codewort gepackt: bit j = code[j]
+// ham_err[w]: 0: OK, j+1: 1-bit-error at j, 0xFF: 2-bit-error
+// (Syndrom H*w, He[j]: 1-bit-error-Syndrome)
+//
+// H[4][8] =  // Parity-Check
+//           {{ 0, 1, 1, 1, 1, 0, 0, 0},
+//            { 1, 0, 1, 1, 0, 1, 0, 0},
+//            { 1, 1, 0, 1, 0, 0, 1, 0},
+//            { 1, 1, 1, 0, 0, 0, 0, 1}};
+// He[8] = { 0x7, 0xB, 0xD, 0xE, 0x8, 0x4, 0x2, 0x1}; // Spalten von H
+static const ui8_t ham_err[256] = {
+    0x00, 0x01, 0x02, 0xFF, 0x03, 0xFF, 0xFF, 0x08, 0x04, 0xFF, 0xFF, 0x07, 0xFF, 0x06, 0x05, 0xFF,
+    0x05, 0xFF, 0xFF, 0x06, 0xFF, 0x07, 0x04, 0xFF, 0xFF, 0x08, 0x03, 0xFF, 0x02, 0xFF, 0x00, 0x01,
+    0x06, 0xFF, 0xFF, 0x05, 0xFF, 0x04, 0x07, 0xFF, 0xFF, 0x03, 0x08, 0xFF, 0x01, 0x00, 0xFF, 0x02,
+    0xFF, 0x02, 0x01, 0x00, 0x08, 0xFF, 0xFF, 0x03, 0x07, 0xFF, 0xFF, 0x04, 0xFF, 0x05, 0x06, 0xFF,
+    0x07, 0xFF, 0xFF, 0x04, 0xFF, 0x05, 0x06, 0xFF, 0xFF, 0x02, 0x01, 0x00, 0x08, 0xFF, 0xFF, 0x03,
+    0xFF, 0x03, 0x08, 0xFF, 0x01, 0x00, 0xFF, 0x02, 0x06, 0xFF, 0xFF, 0x05, 0xFF, 0x04, 0x07, 0xFF,
+    0xFF, 0x08, 0x03, 0xFF, 0x02, 0xFF, 0x00, 0x01, 0x05, 0xFF, 0xFF, 0x06, 0xFF, 0x07, 0x04, 0xFF,
+    0x04, 0xFF, 0xFF, 0x07, 0xFF, 0x06, 0x05, 0xFF, 0x00, 0x01, 0x02, 0xFF, 0x03, 0xFF, 0xFF, 0x08,
+    0x08, 0xFF, 0xFF, 0x03, 0xFF, 0x02, 0x01, 0x00, 0xFF, 0x05, 0x06, 0xFF, 0x07, 0xFF, 0xFF, 0x04,
+    0xFF, 0x04, 0x07, 0xFF, 0x06, 0xFF, 0xFF, 0x05, 0x01, 0x00, 0xFF, 0x02, 0xFF, 0x03, 0x08, 0xFF,
+    0xFF, 0x07, 0x04, 0xFF, 0x05, 0xFF, 0xFF, 0x06, 0x02, 0xFF, 0x00, 0x01, 0xFF, 0x08, 0x03, 0xFF,
+    0x03, 0xFF, 0xFF, 0x08, 0x00, 0x01, 0x02, 0xFF, 0xFF, 0x06, 0x05, 0xFF, 0x04, 0xFF, 0xFF, 0x07,
+    0xFF, 0x06, 0x05, 0xFF, 0x04, 0xFF, 0xFF, 0x07, 0x03, 0xFF, 0xFF, 0x08, 0x00, 0x01, 0x02, 0xFF,
+    0x02, 0xFF, 0x00, 0x01, 0xFF, 0x08, 0x03, 0xFF, 0xFF, 0x07, 0x04, 0xFF, 0x05, 0xFF, 0xFF, 0x06,
+    0x01, 0x00, 0xFF, 0x02, 0xFF, 0x03, 0x08, 0xFF, 0xFF, 0x04, 0x07, 0xFF, 0x06, 0xFF, 0xFF, 0x05,
+    0xFF, 0x05, 0x06, 0xFF, 0x07, 0xFF, 0xFF, 0x04, 0x08, 0xFF, 0xFF, 0x03, 0xFF, 0x02, 0x01, 0x00
+};
+
+// L = 7, 13: codeword i = bits str[L*j+i], j=0..7
+static void deinterleave(char *str, int L, ui8_t *cw) {
     int i, j;
-    for (j = 0; j < B; j++) {  // L = 7, 13
-        for (i = 0; i < L; i++) {
-            if (str[L*j+i] >= 0x30 && str[L*j+i] <= 0x31) {
-                block[B*i+j] = str[L*j+i] - 0x30; // ASCII -> bit
-            }
-        }
+    ui8_t w;
+    for (i = 0; i < L; i++) {
+        w = 0;
+        for (j = 0; j < B; j++) w |= (str[L*j+i] & 1) << j; // ASCII -> bit
+        cw[i] = w;
     }
 }
 
-static int check(ui8_t code[8]) {
-    int i, j;               // Bei Demodulierung durch Nulldurchgaenge, wenn durch Fehler ausser Takt,
-    ui32_t synval = 0;      // verschieben sich die bits. Fuer Hamming-Decode waere es besser,
-    ui8_t syndrom[4];       // sync zu Beginn mit Header und dann Takt beibehalten fuer decision.
-    int ret=0;
-
-    for (i = 0; i < 4; i++) { // S = 4
-        syndrom[i] = 0;
-        for (j = 0; j < 8; j++) { // B = 8
-            syndrom[i] ^= H[i][j] & code[j];
-        }
-    }
-    synval = bits2val(syndrom, 4);
-    if (synval) {
-        ret = -1;
-        for (j = 0; j < 8; j++) {   // 1-bit-error
-            if (synval == He[j]) {  // reicht auf databits zu pruefen, d.h.
-                ret = j+1;          // (systematischer Code) He[0..3]
-                break;
-            }
-        }
-    }
-    else ret = 0;
-    if (ret > 0) code[ret-1] ^= 0x1;
-
-    return ret;
+static int check(ui8_t *cw) {
+    int e = ham_err[*cw];   // Bei Demodulierung durch Nulldurchgaenge, wenn durch Fehler ausser Takt,
+                            // verschieben sich die bits. Fuer Hamming-Decode waere es besser,
+                            // sync zu Beginn mit Header und dann Takt beibehalten fuer decision.
+    if (e == 0xFF) return -1;
+    if (e > 0) *cw ^= 1 << (e-1);
+    return e;
 }
 
-static int hamming(int opt_ecc, ui8_t *ham, int L, ui8_t *sym) {
+static int hamming(int opt_ecc, char *str, int L, ui8_t *sym) {
     int i, j;
     int ecc = 0, ret = 0;      // L = 7, 13
+    ui8_t cw[13];
+    deinterleave(str, L, cw);
     for (i = 0; i < L; i++) {  // L * 2 nibble (data+parity)
         if (opt_ecc) {
-            ecc = check(ham+B*i);
+            ecc = check(cw+i);
             if (ecc > 0) ret |= (1<<i);
             if (ecc < 0) ret |= ecc; // -1
         }
         for (j = 0; j < S; j++) {  // systematic: bits 0..S-1 data
-            sym[S*i+j] = ham[B*i+j];
+            sym[S*i+j] = (cw[i]>>j) & 1;
         }
     }
     return ret;
@@ -880,21 +885,13 @@ static int print_frame(gpx_t *gpx, dsp_t *dsp) {
     int ret0, ret1, ret2;
     int ret = 0;
 
-    ui8_t hamming_conf[ 7*B];  //  7*8=56
-    ui8_t hamming_dat1[13*B];  // 13*8=104
-    ui8_t hamming_dat2[13*B];
-
     ui8_t block_conf[ 7*S];  //  7*4=28
     ui8_t block_dat1[13*S];  // 13*4=52
     ui8_t block_dat2[13*S];
 
-    deinterleave(gpx->frame_bits+CONF,  7, hamming_conf);
-    deinterleave(gpx->frame_bits+DAT1, 13, hamming_dat1);
-    deinterleave(gpx->frame_bits+DAT2, 13, hamming_dat2);
-
-    ret0 = hamming(gpx->option.ecc, hamming_conf,  7, block_conf);
-    ret1 = hamming(gpx->option.ecc, hamming_dat1, 13, block_dat1);
-    ret2 = hamming(gpx->option.ecc, hamming_dat2, 13, block_dat2);
+    ret0 = hamming(gpx->option.ecc, gpx->frame_bits+CONF,  7, block_conf);
+    ret1 = hamming(gpx->option.ecc, gpx->frame_bits+DAT1, 13, block_dat1);
+    ret2 = hamming(gpx->option.ecc, gpx->frame_bits+DAT2, 13, block_dat2);
     ret = ret0 | ret1 | ret2;
 
     if (gpx->option.raw == 1) {
@@ -1055,6 +1052,8 @@ void *thd_dfm09(void *targs) {
     dsp.sr = pcm->sr;
     dsp.sr_base = pcm->sr_base;
     dsp.dectaps = pcm->dectaps;
+    dsp.opt_novec = pcm->opt_novec;
+    dsp.opt_pfb = pcm->opt_pfb;
     dsp.decM = pcm->decM;
 
     dsp.thd = &(tharg->thd);
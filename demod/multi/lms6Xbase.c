@@ -104,17 +104,17 @@ polyB = qA + qB
 #define N (1 << L)
 #define M (1 << (L-1))
 
-typedef struct {
-    ui8_t bIn;
-    ui8_t codeIn;
-    ui8_t prevState;  // 0..M=64
-    float w;
-} states_t;
+// streaming Viterbi: survivor bits packed per step (bit j: predecessor of state j),
+// traceback every VIT_D steps over the last 2*VIT_D steps, the older VIT_D steps are final
+#define VIT_D  64
+#define VIT_TB (2*VIT_D)
 
 typedef struct {
     hsbit_t  rawbits[RAWBITFRAME_LEN+OVERLAP*BITS*2 +8];
-    states_t state[RAWBITFRAME_LEN+OVERLAP +8][M];
-    states_t d[N];
+    float    w[M];          // path metrics
+    ui64_t   dec[VIT_TB];   // survivor bits, ring
+    int t;                  // code pairs processed
+    int t_out;              // code pairs written to rawbits
 } VIT_t;
 
 typedef struct {
@@ -178,16 +178,27 @@ static void Gps2Date(gpx_t *gpx) {
 
 // ------------------------------------------------------------------------
 
+static void vit_reset(VIT_t *vit) {
+    int j;
+    // no renormalization, restarted every block
+    for (j = 0; j < M; j++) vit->w[j] = 1e30f;
+    vit->w[0] = 0.0f;  // start state 0
+    vit->t = 0;
+    vit->t_out = 0;
+}
+
 static ui8_t vit_code[N];
+static float vit_sgn[4][2][M/2];  // code bits {-1,+1} of butterfly branches
 static int vitCodes_init = 0;
 
 static int vit_initCodes(gpx_t *gpx) {
     int cA, cB;
-    int i, bits;
+    int i, b, bits;
 
     VIT_t *pv = calloc(1, sizeof(VIT_t));
     if (pv == NULL) return -1;
     gpx->vit = pv;
+    vit_reset(pv);
 
     if ( vitCodes_init == 0 ) {
         for (bits = 0; bits < N; bits++) {
@@ -199,85 +210,94 @@ static int vit_initCodes(gpx_t *gpx) {
             }
             vit_code[bits] = (cA<<1) | cB;
         }
+        for (b = 0; b < 2; b++) {
+            for (i = 0; i < M/2; i++) {
+                vit_sgn[0][b][i] = 2*((vit_code[2*i+b]>>1) & 1)-1;
+                vit_sgn[1][b][i] = 2*( vit_code[2*i+b]     & 1)-1;
+                vit_sgn[2][b][i] = 2*((vit_code[2*i+b+M]>>1) & 1)-1;
+                vit_sgn[3][b][i] = 2*( vit_code[2*i+b+M]     & 1)-1;
+            }
+        }
         vitCodes_init = 1;
     }
 
     return 0;
 }
 
-static float vit_dist2(int c, hsbit_t *rc) {
-    int c0 = 2*((c>>1) & 1)-1; // {0,1} -> {-1,+1}
-    int c1 = 2*(c & 1)-1;
-    float d2 = (c0-rc[0].sb)*(c0-rc[0].sb) + (c1-rc[1].sb)*(c1-rc[1].sb);
-    return d2;
-}
-
-static int vit_start(VIT_t *vit, hsbit_t *rc) {
-    int t, m, j, c;
-    float d;
-
-    t = L-1;
-    m = M;
-    while ( t > 0 ) {  // t=0..L-2: nextState<M
-        for (j = 0; j < m; j++) {
-            vit->state[t][j].prevState = j/2;
+// add-compare-select, all M states:
+// butterfly i, i+M/2 -> 2i+b (codes 2i+b, 2i+b+M), ties from i;
+// branch metric (c0-r0)^2+(c1-r1)^2, survivor bits packed
+static void vit_acs(VIT_t *vit, hsbit_t *rc) {
+    float r0 = rc[0].sb, r1 = rc[1].sb;
+    float bA[2][M/2], bB[2][M/2];
+    float w0[M], w1[2][M/2];
+    ui8_t d[2][M/2];
+    ui64_t dec = 0;
+    int b, i;
+
+    for (b = 0; b < 2; b++) {
+        for (i = 0; i < M/2; i++) {
+            bA[b][i] = (vit_sgn[0][b][i]-r0)*(vit_sgn[0][b][i]-r0) + (vit_sgn[1][b][i]-r1)*(vit_sgn[1][b][i]-r1);
+            bB[b][i] = (vit_sgn[2][b][i]-r0)*(vit_sgn[2][b][i]-r0) + (vit_sgn[3][b][i]-r1)*(vit_sgn[3][b][i]-r1);
         }
-        t--;
-        m /= 2;
     }
-
-    m = 2;
-    for (t = 1; t < L; t++) {
-        for (j = 0; j < m; j++) {
-            c = vit_code[j];
-            vit->state[t][j].bIn = j % 2;
-            vit->state[t][j].codeIn = c;
-            d = vit_dist2( c, rc+2*(t-1) );
-            vit->state[t][j].w = vit->state[t-1][vit->state[t][j].prevState].w + d;
+    memcpy(w0, vit->w, sizeof(w0));
+    for (b = 0; b < 2; b++) {
+        for (i = 0; i < M/2; i++) {
+            float x = w0[i]     + bA[b][i];
+            float y = w0[i+M/2] + bB[b][i];
+            d[b][i] = (y < x);
+            w1[b][i] = (y < x) ? y : x;
         }
-        m *= 2;
+    }
+    for (i = 0; i < M/2; i++) {
+        vit->w[2*i]   = w1[0][i];
+        vit->w[2*i+1] = w1[1][i];
+        dec |= (ui64_t)(d[0][i] | d[1][i]<<1) << 2*i;
     }
 
-    return t;
+    vit->dec[vit->t % VIT_TB] = dec;
+    vit->t++;
 }
 
-static int vit_next(VIT_t *vit, int t, hsbit_t *rc) {
-    int b, nstate;
-    int j, index;
-
-    for (j = 0; j < M; j++) {
-        for (b = 0; b < 2; b++) {
-            nstate = j*2 + b;
-            vit->d[nstate].bIn = b;
-            vit->d[nstate].codeIn = vit_code[nstate];
-            vit->d[nstate].prevState = j;
-            vit->d[nstate].w = vit->state[t][j].w + vit_dist2( vit->d[nstate].codeIn, rc );
-        }
-     }
+static int vit_best(VIT_t *vit) {
+    int j, j_min = 0;
 
-    for (j = 0; j < M; j++) {
+    for (j = 1; j < M; j++) {
+        if (vit->w[j] < vit->w[j_min]) j_min = j;
+    }
+    return j_min;
+}
 
-        if ( vit->d[j].w <= vit->d[j+M].w ) index = j; else index = j+M;
+// trace back from state j at t, write code pairs t_out+1..t_end
+static void vit_trace(VIT_t *vit, int j, int t_end) {
+    int t, d, c;
 
-        vit->state[t+1][j] = vit->d[index];
+    for (t = vit->t; t > vit->t_out; t--) {
+        d = (vit->dec[(t-1) % VIT_TB] >> j) & 1;
+        if (t <= t_end) {
+            c = vit_code[j + M*d];
+            vit->rawbits[2*t -2].hb = 0x30 + ((c>>1) & 1);
+            vit->rawbits[2*t -1].hb = 0x30 + (c & 1);
+        }
+        j = j/2 + (M/2)*d;
     }
-
-    return 0;
+    vit->t_out = t_end;
 }
 
-static int vit_path(VIT_t *vit, int j, int t) {
-    int c;
-
-    vit->rawbits[2*t].hb = '\0';
-    while (t > 0) {
-        c = vit->state[t][j].codeIn;
-        vit->rawbits[2*t -2].hb = 0x30 + ((c>>1) & 1);
-        vit->rawbits[2*t -1].hb = 0x30 + (c & 1);
-        j = vit->state[t][j].prevState;
-        t--;
+// decode all complete code pairs in rc[0..len-1] (called while demodulating)
+static void vit_feed(VIT_t *vit, hsbit_t *rc, int len) {
+    while ( 2*(vit->t+1) <= len ) {
+        vit_acs(vit, rc+2*vit->t);
+        if (vit->t >= VIT_TB && vit->t % VIT_D == 0) {
+            vit_trace(vit, vit_best(vit), vit->t - VIT_D);
+        }
     }
+}
 
-    return 0;
+static void vit_flush(VIT_t *vit) {
+    vit_trace(vit, vit_best(vit), vit->t);
+    vit->rawbits[2*vit->t].hb = '\0';
 }
 
 static int hbstr_len(hsbit_t *hsbit) {
@@ -286,36 +306,6 @@ static int hbstr_len(hsbit_t *hsbit) {
     return len;
 }
 
-static int viterbi(VIT_t *vit, hsbit_t *rc) {
-    int t, tmax;
-    int j, j_min;
-    float w_min;
-
-    vit_start(vit, rc);
-
-    tmax = hbstr_len(rc)/2;
-
-    for (t = L-1; t < tmax; t++)
-    {
-        vit_next(vit, t, rc+2*t);
-    }
-
-    w_min = -1;
-    for (j = 0; j < M; j++) {
-        if (w_min < 0) {
-            w_min = vit->state[tmax][j].w;
-            j_min = j;
-        }
-        if (vit->state[tmax][j].w < w_min) {
-            w_min = vit->state[tmax][j].w;
-            j_min = j;
-        }
-    }
-    vit_path(vit, j_min, tmax);
-
-    return 0;
-}
-
 // ------------------------------------------------------------------------
 
 static int deconv(hsbit_t *rawbits, char *bits) {
@@ -853,7 +843,8 @@ static void proc_frame(gpx_t *gpx, int len, dsp_t *dsp) {
     flen = len / (2*BITS);
 
     if (gpx->option.vit) {
-        viterbi(gpx->vit, gpx->blk_rawbits);
+        vit_feed(gpx->vit, gpx->blk_rawbits, len);
+        vit_flush(gpx->vit);
         rawbits = gpx->vit->rawbits;
     }
     else rawbits = gpx->blk_rawbits;
@@ -1072,6 +1063,8 @@ void *thd_lms6X(void *targs) { // pcm_t *pcm, double xlt_fq
     dsp.sr = pcm->sr;
     dsp.sr_base = pcm->sr_base;
     dsp.dectaps = pcm->dectaps;
+    dsp.opt_novec = pcm->opt_novec;
+    dsp.opt_pfb = pcm->opt_pfb;
     dsp.decM = pcm->decM;
 
     dsp.thd = &(tharg->thd);
@@ -1164,6 +1157,7 @@ void *thd_lms6X(void *targs) { // pcm_t *pcm, double xlt_fq
 
             bitpos = 0;
             pos = BLOCKSTART;
+            if (gpx->option.vit) vit_reset(gpx->vit);
 
             if (_mv > 0) bc = 0; else bc = 1;
 
@@ -1186,6 +1180,8 @@ void *thd_lms6X(void *targs) { // pcm_t *pcm, double xlt_fq
                 bc++;
                 pos++;
                 bitpos += 1;
+
+                if (gpx->option.vit) vit_feed(gpx->vit, gpx->blk_rawbits, pos);
             }
 
             gpx->blk_rawbits[pos].hb = '\0';
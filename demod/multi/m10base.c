@@ -1198,6 +1198,8 @@ void *thd_m10(void *targs) { // pcm_t *pcm, double xlt_fq
     dsp.sr = pcm->sr;
     dsp.sr_base = pcm->sr_base;
     dsp.dectaps = pcm->dectaps;
+    dsp.opt_novec = pcm->opt_novec;
+    dsp.opt_pfb = pcm->opt_pfb;
     dsp.decM = pcm->decM;
 
     dsp.thd = &(tharg->thd);
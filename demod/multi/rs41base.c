@@ -1184,8 +1184,9 @@ static int rs41_ecc(gpx_t *gpx, int frmlen) {
     int i, leak, ret = 0;
     int errors1, errors2;
     ui8_t cw1[rs_N], cw2[rs_N];
-    ui8_t err_pos1[rs_R], err_pos2[rs_R],
-          err_val1[rs_R], err_val2[rs_R];
+    ui8_t err_pos[2*rs_R], err_val[2*rs_R];
+    ui8_t *cw[2] = { cw1, cw2 };
+    int errs[2];
 
     memset(cw1, 0, rs_N);
     memset(cw2, 0, rs_N);
@@ -1203,8 +1204,9 @@ static int rs41_ecc(gpx_t *gpx, int frmlen) {
     for (i = 0; i < rs_K; i++) cw1[rs_R+i] = gpx->frame[cfg_rs41.msgpos+2*i  ];
     for (i = 0; i < rs_K; i++) cw2[rs_R+i] = gpx->frame[cfg_rs41.msgpos+2*i+1];
 
-    errors1 = rs_decode(&gpx->RS, cw1, err_pos1, err_val1);
-    errors2 = rs_decode(&gpx->RS, cw2, err_pos2, err_val2);
+    rs_decode_batch(&gpx->RS, 2, cw, errs, err_pos, err_val);
+    errors1 = errs[0];
+    errors2 = errs[1];
 
 
     if (gpx->option.ecc == 2 && (errors1 < 0 || errors2 < 0))
@@ -1229,8 +1231,9 @@ static int rs41_ecc(gpx_t *gpx, int frmlen) {
         }
         for (i = 0; i < rs_K; i++) cw1[rs_R+i] = gpx->frame[cfg_rs41.msgpos+2*i  ];
         for (i = 0; i < rs_K; i++) cw2[rs_R+i] = gpx->frame[cfg_rs41.msgpos+2*i+1];
-        errors1 = rs_decode(&gpx->RS, cw1, err_pos1, err_val1);
-        errors2 = rs_decode(&gpx->RS, cw2, err_pos2, err_val2);
+        rs_decode_batch(&gpx->RS, 2, cw, errs, err_pos, err_val);
+        errors1 = errs[0];
+        errors2 = errs[1];
     }
 
 
@@ -1804,6 +1807,8 @@ void *thd_rs41(void *targs) { // pcm_t *pcm, double xlt_fq
     dsp.sr = pcm->sr;
     dsp.sr_base = pcm->sr_base;
     dsp.dectaps = pcm->dectaps;
+    dsp.opt_novec = pcm->opt_novec;
+    dsp.opt_pfb = pcm->opt_pfb;
     dsp.decM = pcm->decM;
 
     dsp.thd = &(tharg->thd);
@@ -20,6 +20,9 @@ echo "m10 -0.36" > rsfifo
 echo "-1" > rsfifo
 echo "lms 0.02428" > rsfifo
 
+scan (carriers above noise floor -> probe channels rs41/dfm/m10/lms):
+./a.out --scan [--scan_db 5] baseband_IQ.wav
+
 */
 
 
@@ -38,12 +41,18 @@ echo "lms 0.02428" > rsfifo
 
 
 static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
-static pthread_cond_t  cond  = PTHREAD_COND_INITIALIZER;
 //static pthread_rwlock_t lock = PTHREAD_RWLOCK_INITIALIZER;
 
-static float complex *block_decMB;
+static ring_t ring; // IQ blocks: reader thread -> decoder channels
+static pool_t pool; // worker threads, channels scheduled onto workers
+
+static thargs_t **tharg = NULL; // channel table
+static int n_ch = 0;
+
+static double *base_fqs = NULL;
+static void **rstype = NULL;
+static int xlt_cnt = 0;
 
-extern int rbf1;   // demod_base.c
 extern int bufeof; // demod_base.c
 
 void *thd_rs41(void *);
@@ -51,6 +60,206 @@ void *thd_dfm09(void *);
 void *thd_m10(void *);
 void *thd_lms6X(void *);
 
+// channel defaults (fifo/scan)
+static pcm_t ch_pcm;
+static int ch_cfreq = -1;
+static int ch_jsn = 0, ch_dc = 0, ch_cnt = 0;
+
+
+// channel k, table grows on demand
+static thargs_t *ch_arg(int k) {
+    if (k >= n_ch) {
+        int n = 2*n_ch;
+        thargs_t **tab;
+        if (n < k+1) n = k+1;
+        tab = realloc(tharg, n*sizeof(thargs_t *));  if (tab == NULL) return NULL;
+        tharg = tab;
+        while (n_ch < n) {
+            tharg[n_ch] = calloc(1, sizeof(thargs_t));  if (tharg[n_ch] == NULL) return NULL;
+            n_ch++;
+        }
+    }
+    return tharg[k];
+}
+
+static int add_fq(double fq, void *rst) {
+    if ((xlt_cnt & (xlt_cnt-1)) == 0) { // 0,1,2,4,...: double
+        int n = xlt_cnt ? 2*xlt_cnt : 1;
+        double *fqs = realloc(base_fqs, n*sizeof(double));
+        void **rsts;
+        if (fqs == NULL) return -1;
+        base_fqs = fqs;
+        rsts = realloc(rstype, n*sizeof(void *));  if (rsts == NULL) return -1;
+        rstype = rsts;
+    }
+    base_fqs[xlt_cnt] = fq;
+    rstype[xlt_cnt] = rst;
+    xlt_cnt++;
+    return xlt_cnt;
+}
+
+
+// new channel in free slot; probe: close quietly if no header
+static int ch_add(double fq, void *rst, int probe) {
+    int k;
+
+    for (k = 0; k < n_ch; k++) {
+        if (atomic_load(&tharg[k]->thd.state) == CH_OFF) break;
+    }
+    if (ch_arg(k) == NULL) return -1;
+
+    tharg[k]->thd.tn = k;
+    tharg[k]->thd.mutex = &mutex;
+    //tharg[k]->thd.lock = &lock;
+    tharg[k]->thd.ring = &ring;
+    tharg[k]->thd.xlt_fq = -fq;
+    tharg[k]->thd.probe = probe;
+    if (ch_cfreq > 0) {
+        int fq_kHz = (ch_cfreq - tharg[k]->thd.xlt_fq*ch_pcm.sr_base + 500)/1e3;
+        tharg[k]->jsn_freq = fq_kHz;
+    }
+
+    tharg[k]->pcm = ch_pcm;
+
+    tharg[k]->option_jsn = ch_jsn;
+    tharg[k]->option_dc  = ch_dc;
+    tharg[k]->option_cnt = ch_cnt;  // probe: closed after SEC_PROBE without header, independent of -c
+
+    if (ring_join(&ring, k) < 0) return -1;
+    tharg[k]->thd.used = 1;
+
+    if (pool_add(&pool, &tharg[k]->thd, rst, tharg[k]) < 0) {
+        tharg[k]->thd.used = 0;
+        ring_leave(&ring, k);
+        return -1;
+    }
+
+    return k;
+}
+
+
+// scan: carrier -> one probe channel per type,
+// first header keeps its channel, no header -> carrier ignored for SCAN_RETRY spectra
+#define SCAN_DB     5.0
+#define SCAN_SEP    10e3  // Hz, min. distance to channel
+#define SCAN_RETRY  60
+#define SCAN_TYPES  4
+
+enum { CAR_FREE = 0, CAR_PROBE, CAR_ON, CAR_FAIL };
+
+typedef struct {
+    double fq;
+    int k[SCAN_TYPES];
+    int state;
+    int until;
+} scan_car_t;
+
+static scan_t scan;
+static int scan_k = -1; // scanner channel
+static int scan_seq = 0;
+static scan_car_t *car = NULL;
+static int n_car = 0;
+
+static void *scan_types[SCAN_TYPES] = { thd_rs41, thd_dfm09, thd_m10, thd_lms6X };
+
+// carriers of spectrum seq: check probes, new carriers -> probes
+static int scan_probe(int seq, int n, double *fq, float *db) {
+    int i, j, k, run, on;
+    double sep = SCAN_SEP / (double)ch_pcm.sr_base;
+    scan_car_t *c;
+
+    for (i = 0; i < n_car; i++) {
+        c = car+i;
+        if (c->state == CAR_FREE) continue;
+        if (c->state == CAR_FAIL) {
+            if (seq >= c->until) c->state = CAR_FREE;
+            continue;
+        }
+        run = 0; on = -1;
+        for (j = 0; j < SCAN_TYPES; j++) {
+            k = c->k[j];
+            if (k < 0) continue;
+            if (tharg[k]->thd.used == 0) { c->k[j] = -1; continue; }
+            if (tharg[k]->thd.probe == 0) on = j;
+            run++;
+        }
+        if (on >= 0) {
+            for (j = 0; j < SCAN_TYPES; j++) {
+                if (j != on && c->k[j] >= 0) {
+                    tharg[c->k[j]]->thd.used = 0;
+                    c->k[j] = -1;
+                }
+            }
+            c->state = CAR_ON;
+        }
+        else if (run == 0) {
+            if (c->state == CAR_ON) c->state = CAR_FREE; // signal lost
+            else {
+                c->state = CAR_FAIL;
+                c->until = seq + SCAN_RETRY;
+            }
+        }
+    }
+
+    for (i = 0; i < n; i++) {
+        for (k = 0; k < n_ch; k++) {
+            if (k == scan_k || tharg[k]->thd.used == 0) continue;
+            if (fabs(fq[i] + tharg[k]->thd.xlt_fq) < sep) break;
+        }
+        if (k < n_ch) continue;
+        for (j = 0; j < n_car; j++) {
+            if (car[j].state != CAR_FREE && fabs(fq[i] - car[j].fq) < sep) break;
+        }
+        if (j < n_car) continue;
+
+        for (j = 0; j < n_car; j++) {
+            if (car[j].state == CAR_FREE) break;
+        }
+        if (j == n_car) {
+            c = realloc(car, (n_car+1)*sizeof(scan_car_t));  if (c == NULL) return -1;
+            car = c;
+            n_car++;
+        }
+        c = car+j;
+        c->fq = fq[i];
+        c->state = CAR_PROBE;
+
+        fprintf(stderr, "scan: f=%+.4f (%.1f dB)\n", fq[i], db[i]);
+
+        for (j = 0; j < SCAN_TYPES; j++) {
+            int m, l;
+            k = ch_add(fq[i], scan_types[j], 1);
+            c->k[j] = k;
+            if (k < 0) continue;
+            for (m = 0; m < n_car; m++) { // slot reused
+                if (car+m == c) continue;
+                for (l = 0; l < SCAN_TYPES; l++) if (car[m].k[l] == k) car[m].k[l] = -1;
+            }
+        }
+    }
+
+    return n;
+}
+
+
+static int scan_update() {
+    int i, n, seq;
+    double fq[SCAN_MAXCAR];
+    float db[SCAN_MAXCAR];
+
+    pthread_mutex_lock( &scan.lock );
+    seq = scan.seq;
+    n = scan.n;
+    for (i = 0; i < n; i++) { fq[i] = scan.fq[i]; db[i] = scan.db[i]; }
+    pthread_mutex_unlock( &scan.lock );
+
+    if (seq == scan_seq) return 0;
+    scan_seq = seq;
+    scan_probe(seq, n, fq, db);
+    atomic_store(&scan.ack, seq); // scanner continues
+    return n;
+}
+
 
 #define IF_SAMPLE_RATE      48000
 #define IF_SAMPLE_RATE_MIN  32000
@@ -106,15 +315,19 @@ int main(int argc, char **argv) {
     FILE *fp;
     int wavloaded = 0;
     int k;
-    int xlt_cnt = 0;
     int cfreq = -1;
-    double base_fqs[MAX_FQ];
-    void *rstype[MAX_FQ];
     int option_pcmraw = 0,
         option_jsn = 0,
         option_dc  = 0,
         option_min = 0,
-        option_cont = 0;
+        option_noVEC = 0,
+        option_drop = 0,
+        option_pfb = 0,
+        option_cont = 0,
+        option_scan = 0;
+    float scan_db = SCAN_DB;
+    int ring_depth = RING_DEPTH;
+    int n_workers = 0; // 0: #cpu
 
     // FIFO
     int  option_fifo = 0;
@@ -131,8 +344,6 @@ int main(int argc, char **argv) {
 
     pcm_t pcm = {0};
 
-    for (k = 0; k < MAX_FQ; k++) base_fqs[k] = 0.0;
-
     ++argv;
     while ((*argv) && (!wavloaded)) {
         if (strcmp(*argv, "--rs41") == 0) {
@@ -141,11 +352,7 @@ int main(int argc, char **argv) {
             if (*argv) fq = atof(*argv); else return -1;
             if (fq < -0.5) fq = -0.5;
             if (fq >  0.5) fq =  0.5;
-            if (xlt_cnt < MAX_FQ) {
-                base_fqs[xlt_cnt] = fq;
-                rstype[xlt_cnt] = thd_rs41;
-                xlt_cnt++;
-            }
+            if (add_fq(fq, thd_rs41) < 0) return -1;
         }
         else if (strcmp(*argv, "--dfm") == 0) {
             double fq = 0.0;
@@ -153,11 +360,7 @@ int main(int argc, char **argv) {
             if (*argv) fq = atof(*argv); else return -1;
             if (fq < -0.5) fq = -0.5;
             if (fq >  0.5) fq =  0.5;
-            if (xlt_cnt < MAX_FQ) {
-                base_fqs[xlt_cnt] = fq;
-                rstype[xlt_cnt] = thd_dfm09;
-                xlt_cnt++;
-            }
+            if (add_fq(fq, thd_dfm09) < 0) return -1;
         }
         else if (strcmp(*argv, "--m10") == 0) {
             double fq = 0.0;
@@ -165,11 +368,7 @@ int main(int argc, char **argv) {
             if (*argv) fq = atof(*argv); else return -1;
             if (fq < -0.5) fq = -0.5;
             if (fq >  0.5) fq =  0.5;
-            if (xlt_cnt < MAX_FQ) {
-                base_fqs[xlt_cnt] = fq;
-                rstype[xlt_cnt] = thd_m10;
-                xlt_cnt++;
-            }
+            if (add_fq(fq, thd_m10) < 0) return -1;
         }
         else if (strcmp(*argv, "--lms") == 0) {
             double fq = 0.0;
@@ -177,11 +376,7 @@ int main(int argc, char **argv) {
             if (*argv) fq = atof(*argv); else return -1;
             if (fq < -0.5) fq = -0.5;
             if (fq >  0.5) fq =  0.5;
-            if (xlt_cnt < MAX_FQ) {
-                base_fqs[xlt_cnt] = fq;
-                rstype[xlt_cnt] = thd_lms6X;
-                xlt_cnt++;
-            }
+            if (add_fq(fq, thd_lms6X) < 0) return -1;
         }
         else if   (strcmp(*argv, "--json") == 0) {
             option_jsn = 1;
@@ -199,6 +394,30 @@ int main(int argc, char **argv) {
         else if   (strcmp(*argv, "--min") == 0) {
             option_min = 1;
         }
+        else if   (strcmp(*argv, "--noVEC") == 0) {
+            option_noVEC = 1;
+        }
+        else if   (strcmp(*argv, "--ring") == 0) { // ring depth / blocks
+            ++argv;
+            if (*argv) ring_depth = atoi(*argv); else return -1;
+        }
+        else if   (strcmp(*argv, "--drop") == 0) { // slow channels drop blocks
+            option_drop = 1;
+        }
+        else if   (strcmp(*argv, "--pfb") == 0) { // channelizer front end
+            option_pfb = 1;
+        }
+        else if   (strcmp(*argv, "--workers") == 0) { // worker threads (default: #cpu)
+            ++argv;
+            if (*argv) n_workers = atoi(*argv); else return -1;
+        }
+        else if   (strcmp(*argv, "--scan") == 0) { // carrier scanner, probe channels
+            option_scan = 1;
+        }
+        else if   (strcmp(*argv, "--scan_db") == 0) { // scan: dB above noise floor
+            ++argv;
+            if (*argv) scan_db = atof(*argv); else return -1;
+        }
         else if ( (strcmp(*argv, "-c") == 0) || (strcmp(*argv, "--cnt") == 0) ) {
             option_cont = 1;
         }
@@ -254,52 +473,83 @@ int main(int argc, char **argv) {
     }
 
     pcm.opt_IFmin = option_min;
+    pcm.opt_novec = option_noVEC;
     pcm_dec_init( &pcm );
+    if (option_scan && option_pfb) {
+        fprintf(stderr, "scan: no --pfb\n"); // scanner needs raw IQ blocks
+        option_pfb = 0;
+    }
+    pcm.opt_pfb = (option_pfb && pcm.decM > 1);
 
+    ch_pcm = pcm;
+    ch_cfreq = cfreq;
+    ch_jsn = option_jsn;
+    ch_dc  = option_dc;
+    ch_cnt = option_cont;
 
-    block_decMB = calloc(pcm.decM*blk_sz+1, sizeof(float complex));  if (block_decMB == NULL) return -1;
 
+    if (ring_init(&ring, &pcm, ring_depth, option_drop) < 0) return -1;
+    if (pool_init(&pool, n_workers) < 0) return -1;
 
-    thargs_t tharg[MAX_FQ]; // xlt_cnt<=MAX_FQ
-    for (k = 0; k < MAX_FQ; k++) tharg[k].thd.used = 0;
 
     for (k = 0; k < xlt_cnt; k++) {
-        tharg[k].thd.tn = k;
-        tharg[k].thd.tn_bit = (1<<k);
-        tharg[k].thd.mutex = &mutex;
-        tharg[k].thd.cond = &cond;
-        //tharg[k].thd.lock = &lock;
-        tharg[k].thd.blk = block_decMB;
-        tharg[k].thd.max_fq = xlt_cnt;
-        tharg[k].thd.xlt_fq = -base_fqs[k]; // S(t)*exp(-f*2pi*I*t): fq baseband -> IF (rotate from and decimate)
+        if (ch_arg(k) == NULL) return -1;
+        tharg[k]->thd.tn = k;
+        tharg[k]->thd.mutex = &mutex;
+        //tharg[k]->thd.lock = &lock;
+        tharg[k]->thd.ring = &ring;
+        tharg[k]->thd.xlt_fq = -base_fqs[k]; // S(t)*exp(-f*2pi*I*t): fq baseband -> IF (rotate from and decimate)
         if (cfreq > 0) {
-            int fq_kHz = (cfreq - tharg[k].thd.xlt_fq*pcm.sr_base + 500)/1e3;
-            tharg[k].jsn_freq = fq_kHz;
+            int fq_kHz = (cfreq - tharg[k]->thd.xlt_fq*pcm.sr_base + 500)/1e3;
+            tharg[k]->jsn_freq = fq_kHz;
         }
 
-        tharg[k].pcm = pcm;
+        tharg[k]->pcm = pcm;
 
-        tharg[k].option_jsn = option_jsn;
-        tharg[k].option_dc  = option_dc;
-        tharg[k].option_cnt = option_cont;
+        tharg[k]->option_jsn = option_jsn;
+        tharg[k]->option_dc  = option_dc;
+        tharg[k]->option_cnt = option_cont;
 
-        rbf1 |= tharg[k].thd.tn_bit;
-        tharg[k].thd.used = 1;
+        if (ring_join(&ring, k) < 0) return -1;
+        tharg[k]->thd.used = 1;
     }
 
-    for (k = 0; k < xlt_cnt; k++) {
-        pthread_create(&tharg[k].thd.tid, NULL, rstype[k], &tharg[k]);
+    if (option_scan) {
+        k = xlt_cnt;
+        if (ch_arg(k) == NULL) return -1;
+        pthread_mutex_init(&scan.lock, NULL);
+        scan.thres = scan_db;
+        tharg[k]->thd.tn = k;
+        tharg[k]->thd.mutex = &mutex;
+        tharg[k]->thd.ring = &ring;
+        tharg[k]->pcm = pcm;
+        tharg[k]->scan = &scan;
+        if (ring_join(&ring, k) < 0) return -1;
+        tharg[k]->thd.used = 1;
+        scan_k = k;
     }
 
+    for (k = 0; k < xlt_cnt + option_scan; k++) {
+        void *fn = (k == scan_k) ? thd_scan : rstype[k];
+        if (pool_add(&pool, &tharg[k]->thd, fn, tharg[k]) < 0) {
+            fprintf(stderr, "error: channel %d\n", k);
+            tharg[k]->thd.used = 0;
+            ring_leave(&ring, k);
+        }
+    }
+    pthread_create(&ring.tid, NULL, thd_ring, &ring);
 
-    // FIFO
+
+    // FIFO / scan
     //
-    if (option_fifo)
+    if (option_fifo || option_scan)
     {
-        fd = open(rs_fifo, O_RDONLY | O_NONBLOCK); //fcntl.h
-        if (fd < 0) {
-            fprintf(stderr, "error open %s\n", rs_fifo);
-            return -1;
+        if (option_fifo) {
+            fd = open(rs_fifo, O_RDONLY | O_NONBLOCK); //fcntl.h
+            if (fd < 0) {
+                fprintf(stderr, "error open %s\n", rs_fifo);
+                return -1;
+            }
         }
 
         while ( !bufeof ) {
@@ -307,37 +557,39 @@ int main(int argc, char **argv) {
             memset(fifo_buf, 0, FIFOBUF_LEN);
 
             th_used = 0;
-            for (k = 0; k < MAX_FQ; k++) th_used += tharg[k].thd.used;
+            for (k = 0; k < n_ch; k++) th_used += tharg[k]->thd.used;
             if (th_used == 0) break;
 
-            l = read(fd, fifo_buf, FIFOBUF_LEN);
+            if (option_scan) scan_update();
+
+            if (fd >= 0) l = read(fd, fifo_buf, FIFOBUF_LEN);
             if ( l > 1 ) {
-                void *rstype = NULL;
+                void *fn = NULL;
                 char *fifo_fq = fifo_buf;
                 while (l > 1 && fifo_buf[l-1] < 0x20) l--;
                 fifo_buf[l] = '\0'; // remove \n, terminate string
                 if (strncmp(fifo_buf, "rs41", 4) == 0) {
                     fifo_fq = fifo_buf + 4;
-                    rstype = thd_rs41;
+                    fn = thd_rs41;
                 }
                 else if (strncmp(fifo_buf, "dfm", 3) == 0) {
                     fifo_fq = fifo_buf + 3;
-                    rstype = thd_dfm09;
+                    fn = thd_dfm09;
                 }
                 else if (strncmp(fifo_buf, "m10", 3) == 0) {
                     fifo_fq = fifo_buf + 3;
-                    rstype = thd_m10;
+                    fn = thd_m10;
                 }
                 else if (strncmp(fifo_buf, "lms", 3) == 0) {
                     fifo_fq = fifo_buf + 3;
-                    rstype = thd_lms6X;
+                    fn = thd_lms6X;
                 }
                 else {
                     if (fifo_buf[0] == '-') { // -<n> : close <n>
                         int num = atoi(fifo_buf+1);
-                        if (num >= 0 && num < MAX_FQ) {
-                            if (tharg[num].thd.used) {
-                                tharg[num].thd.used = 0;
+                        if (num >= 0 && num < n_ch) {
+                            if (tharg[num]->thd.used) {
+                                tharg[num]->thd.used = 0;
                             }
                         }
                     }
@@ -350,62 +602,34 @@ int main(int argc, char **argv) {
                 if (fq < -0.5) fq = -0.5;
                 if (fq >  0.5) fq =  0.5;
 
-                // find slot
-                for (k = 0; k < MAX_FQ; k++) {
-                    if (tharg[k].thd.used == 0) break;
-                }
-                if (k < MAX_FQ) {
-                    double base_fq = fq;
-
-                    tharg[k].thd.tn = k;
-                    tharg[k].thd.tn_bit = (1<<k);
-                    tharg[k].thd.mutex = &mutex;
-                    tharg[k].thd.cond = &cond;
-                    //tharg[k].thd.lock = &lock;
-                    tharg[k].thd.blk = block_decMB;
-                    tharg[k].thd.xlt_fq = -base_fq;
-                    if (cfreq > 0) {
-                        int fq_kHz = (cfreq - tharg[k].thd.xlt_fq*pcm.sr_base + 500)/1e3;
-                        tharg[k].jsn_freq = fq_kHz;
-                    }
-
-                    tharg[k].pcm = pcm;
-
-                    tharg[k].option_jsn = option_jsn;
-                    tharg[k].option_dc  = option_dc;
-
-                    rbf1 |= tharg[k].thd.tn_bit;
-                    tharg[k].thd.used = 1;
-
-                    pthread_create(&tharg[k].thd.tid, NULL, rstype, &tharg[k]);
-
+                k = ch_add(fq, fn, 0);
+                if (k >= 0) {
                     pthread_mutex_lock( &mutex );
-                    fprintf(stdout, "<%d: add f=%+.4f>\n", k, base_fq);
+                    fprintf(stdout, "<%d: add f=%+.4f>\n", k, fq);
                     pthread_mutex_unlock( &mutex );
-
-                    k++;
-                    if (k > xlt_cnt) xlt_cnt = k;
-                    for (k = 0; k < xlt_cnt; k++) {
-                        tharg[k].thd.max_fq = xlt_cnt;
-                    }
-
                 }
             }
-            sleep(1);
+            if (option_scan) usleep(1000); // scanner waits for probes
+            else sleep(1);
         }
     }
 
-    for (k = 0; k < xlt_cnt; k++) {
-        pthread_join(tharg[k].thd.tid, NULL);
-    }
+    pool_join(&pool); // all channels done
+
+    atomic_store(&ring.stop, 1);
+    pthread_join(ring.tid, NULL);
 
-    th_used = 1;
-    while (th_used) {
-        th_used = 0;
-        for (k = 0; k < MAX_FQ; k++) th_used += tharg[k].thd.used;
+    for (k = 0; k < atomic_load(&ring.nc); k++) {
+        ring_cons_t *c = ring_cons(&ring, k);
+        if (c->drop > 0) fprintf(stderr, "<%d: %u blocks dropped>\n", k, c->drop);
     }
+    ring_free(&ring);
 
-    if (block_decMB) { free(block_decMB); block_decMB = NULL; }
+    for (k = 0; k < n_ch; k++) free(tharg[k]);
+    free(tharg); tharg = NULL;
+    free(base_fqs); base_fqs = NULL;
+    free(rstype); rstype = NULL;
+    free(car); car = NULL;
     decimate_free();
 
     fclose(fp);
@@ -175,8 +175,6 @@ int    bitpos;
 ui8_t  bitframe[LEN_BITFRAME+1] = { 0, 1, 0, 0, 0, 0, 0, 0, 0, 1};
 ui8_t  byteframe[LEN_BYTEFRAME+1];
 
-int    N, ptr;
-float *buffer = NULL;
 
 
 /* ------------------------------------------------------------------------------------ */
@@ -644,8 +642,91 @@ int print_frame(int len) {
 
 /* -------------------------------------------------------------------------- */
 
-double complex F1sum = 0;
-double complex F2sum = 0;
+/*
+   AFSK Bell202, Quadratur-Korrelator:
+   Mischung mit f0=2200Hz (bit 0) und f1=1200Hz (bit 1) per NCO,
+   Integration ueber 1 bit (boxcar, laufende Summe),
+   soft bit  (|S1|^2-|S0|^2)/(|S1|^2+|S0|^2) , blockweise
+*/
+
+#define AFSK_BLK  1024  // samples/block
+
+#define CLK_GAIN  0.125 // Takt-Regelung (UART): Flanke in der Mitte zwischen zwei Abtastpunkten
+
+typedef struct {
+    int n;                 // boxcar: sr/baud
+    int f[2];
+    int L[2];              // NCO-Tabelle, Periode sr/ggT(f,sr)
+    int ph[2];
+    float complex *ex[2];
+    double complex S[2];   // laufende Summen
+    float complex *X[2];   // Summanden im Fenster
+    int j;
+} afsk_t;
+
+int gcd(int a, int b) {
+    while (b) { int r = a % b; a = b; b = r; }
+    return a;
+}
+
+int afsk_init(afsk_t *a, int sr, double br) {
+    int k, m;
+
+    a->n = sr/br;
+    a->j = 0;
+    a->f[0] = 2200;  // bit0: 2200Hz
+    a->f[1] = 1200;  // bit1: 1200Hz
+    for (k = 0; k < 2; k++) {
+        a->L[k] = sr / gcd(a->f[k], sr);
+        a->ph[k] = 0;
+        a->ex[k] = calloc(a->L[k]+1, sizeof(float complex));
+        if (a->ex[k] == NULL) return -1;
+        for (m = 0; m < a->L[k]; m++) {
+            a->ex[k][m] = cexp(-2*M_PI*a->f[k]*(double)m/(double)sr*I);
+        }
+        a->S[k] = 0;
+        a->X[k] = calloc(a->n+1, sizeof(float complex));
+        if (a->X[k] == NULL) return -1;
+    }
+    return 0;
+}
+
+void afsk_free(afsk_t *a) {
+    int k;
+    for (k = 0; k < 2; k++) {
+        if (a->ex[k]) { free(a->ex[k]); a->ex[k] = NULL; }
+        if (a->X[k])  { free(a->X[k]);  a->X[k]  = NULL; }
+    }
+}
+
+void afsk_block(afsk_t *a, float *x, float *soft, int len) {
+    int i, k;
+    double p[2];
+    float complex c;
+
+    for (i = 0; i < len; i++) {
+        for (k = 0; k < 2; k++) {
+            c = x[i] * a->ex[k][a->ph[k]];
+            a->ph[k] += 1; if (a->ph[k] >= a->L[k]) a->ph[k] = 0;
+            a->S[k] -= a->X[k][a->j];
+            a->S[k] += c;
+            a->X[k][a->j] = c;
+            p[k] = creal(a->S[k])*creal(a->S[k]) + cimag(a->S[k])*cimag(a->S[k]);
+        }
+        a->j += 1; if (a->j >= a->n) a->j = 0;
+        soft[i] = p[0]+p[1] > 0 ? (p[1]-p[0])/(p[1]+p[0]) : 0;
+    }
+}
+
+int f32_block(FILE *fp, float *x, int len) {
+    int i;
+    for (i = 0; i < len; i++) {
+        if (f32read_sample(fp, x+i) == EOF) break;
+    }
+    return i;
+}
+
+/* -------------------------------------------------------------------------- */
 
 int main(int argc, char *argv[]) {
 
@@ -653,27 +734,20 @@ int main(int argc, char *argv[]) {
     char *fpname;
     unsigned int sample_count;
     int i;
-    int bit = 8, bit0 = 8;
-    int pos = 0, pos0 = 0;
-    double pos_bit = 0;
+    int bit = 8, bit0 = 8, bitp = 8;
+    double pos = 0, pos0 = 0;
+    double pos_bit = 0; // naechster Abtastpunkt
+    double tc;          // Flanke
     int header_found = 0;
     double bitlen; // sample_rate/BAUD_RATE
     int len;
-    double f1, f2;
 
-    int n;
-    double t  = 0.0;
-    double tn = 0.0;
-    double x  = 0.0;
-    double x0 = 0.0;
+    int n, k;
+    float s = 0.0, s0 = 0.0;
+    float sbuf[3] = {0};
 
-    double complex X0 = 0;
-    double complex X  = 0;
-
-    double xbit = 0.0;
-    float s = 0.0;
-
-    int bitbuf[3];
+    afsk_t afsk = {0};
+    static float xs[AFSK_BLK], soft[AFSK_BLK];
 
     int cfreq = -1;
 
@@ -733,53 +807,35 @@ int main(int argc, char *argv[]) {
 
     bitlen = sample_rate/(double)BAUD_RATE;
 
-    f1 = 2200.0;  // bit0: 2200Hz
-    f2 = 1200.0;  // bit1: 1200Hz
-
-    N = 2*bitlen + 0.5;
-    buffer = calloc( N+1, sizeof(float)); if (buffer == NULL) return -1;
-
-    ptr = -1; sample_count = -1;
-
-    while (f32read_sample(fp, &s) != EOF) {
+    if (afsk_init(&afsk, sample_rate, BAUD_RATE) < 0) return -1;
 
-        ptr++; sample_count++;
-        if (ptr == N) ptr = 0;
-        buffer[ptr] = s;
+    sample_count = -1;
 
-        n = bitlen;
-        t = sample_count / (double)sample_rate;
-        tn = (sample_count-n) / (double)sample_rate;
+    while ( (n = f32_block(fp, xs, AFSK_BLK)) > 0 ) {
 
-        x = buffer[sample_count % N];
-        x0 = buffer[(sample_count - n + N) % N];
+      afsk_block(&afsk, xs, soft, n);
 
-        // f1
-        X0 = x0 * cexp(-tn*2*M_PI*f1*I); // alt
-        X  = x  * cexp(-t *2*M_PI*f1*I); // neu
-        F1sum +=  X - X0;
-
-        // f2
-        X0 = x0 * cexp(-tn*2*M_PI*f2*I); // alt
-        X  = x  * cexp(-t *2*M_PI*f2*I); // neu
-        F2sum +=  X - X0;
-
-        xbit = cabs(F2sum) - cabs(F1sum);
-
-        s = xbit / bitlen;
+      for (k = 0; k < n; k++) {
 
+        sample_count++;
+        s0 = s;
+        s = soft[k];
+        sbuf[sample_count % 3] = s;
 
         if ( s < 0 ) bit = 0;  // 2200Hz
         else         bit = 1;  // 1200Hz
 
-        bitbuf[sample_count % 3] = bit;
+        tc = sample_count;
+        if (bit != bitp && s != s0) tc -= s/(s-s0);  // soft Nulldurchgang zwischen den Samples
 
         if (header_found && option_b)
         {
-            if (sample_count - pos_bit > bitlen+bitlen/5 + 3)
+            if (bit != bitp) {
+                pos_bit += CLK_GAIN * (tc - (pos_bit - bitlen/2.0));
+            }
+            if (sample_count >= pos_bit + 1)  // soft bits um den Abtastpunkt
             {
-                int bitsum = bitbuf[0]+bitbuf[1]+bitbuf[2];
-                if (bitsum > 1.5) bit = 1; else bit = 0;
+                if (sbuf[0]+sbuf[1]+sbuf[2] < 0) bit = 0; else bit = 1;
 
                 bitframe[bitpos] = bit;
                 bitpos++;
@@ -798,7 +854,7 @@ int main(int argc, char *argv[]) {
             if (bit != bit0) {
 
                 pos0 = pos;
-                pos = sample_count;  //sample_count-(N-1)/2
+                pos = tc;
 
                 len =  (pos-pos0)/bitlen + 0.5;
                 for (i = 0; i < len; i++) {
@@ -809,7 +865,7 @@ int main(int argc, char *argv[]) {
                         if (compare() >= HEADLEN) {
                             header_found = 1;
                             bitpos = 10;
-                            pos_bit = pos;
+                            pos_bit = pos + 1.5*bitlen;  // Flanke: halbes bit nach Beginn (boxcar), Abtastung am bit-Ende
                             if (option_b) {
                                 bitframe[bitpos] = bit;
                                 bitpos++;
@@ -831,10 +887,12 @@ int main(int argc, char *argv[]) {
                 bit0 = bit;
             }
         }
+        bitp = (s < 0) ? 0 : 1;
+      }
     }
     fprintf(stdout, "\n");
 
-    if (buffer) { free(buffer); buffer = NULL; }
+    afsk_free(&afsk);
 
     fclose(fp);
 
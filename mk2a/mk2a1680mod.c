@@ -771,6 +771,19 @@ static float re_lowpass(float buffer[], ui32_t sample, ui32_t taps, float *ws) {
 }
 
 
+// FM discriminator: atan2() polynomial, |err| < 1e-5 rad (Abramowitz/Stegun 4.4.49), no libm
+static inline float atan2_poly(float y, float x) {
+    float ax = fabsf(x), ay = fabsf(y);
+    float mx = ax > ay ? ax : ay;
+    float mn = ax > ay ? ay : ax;
+    float a = mx > 0.0f ? mn/mx : 0.0f;
+    float q = a*a;
+    float r = a*(0.9998660f + q*(-0.3302995f + q*(0.1801410f + q*(-0.0851330f + q*0.0208351f))));
+    r = ay > ax ? (float)(M_PI/2.0) - r : r;
+    r = x < 0.0f ? (float)M_PI - r : r;
+    return y < 0.0f ? -r : r;
+}
+
 static
 int f32buf_sample(dsp_t *dsp, int inv) {
     float s = 0.0;
@@ -831,7 +844,7 @@ int f32buf_sample(dsp_t *dsp, int inv) {
 
             z0 = dsp->rot_iqbuf[(_sample-1 + dsp->N_IQBUF) % dsp->N_IQBUF];
             w = z * conj(z0);
-            s_fm = gain * carg(w)/M_PI;
+            s_fm = gain * atan2_poly(cimagf(w), crealf(w))/M_PI;
 
             dsp->rot_iqbuf[_sample % dsp->N_IQBUF] = z;
 
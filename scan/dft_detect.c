@@ -224,6 +224,10 @@ static float complex  *ew;
 
 static float complex  *X, *Z, *cx;
 static float *xn;
+static float *xb[3];             // Fenster je buf_fm[]
+static float complex *Xb[3];
+static float *xbf[3][2];         // FM-lowpass(xb), iq
+static float *xcorr[2];
 static float *db;
 
 // FM: lowpass
@@ -299,92 +303,169 @@ static float bin2freq(int k) {
 
 /* ------------------------------------------------------------------------------------ */
 
-static int getCorrDFT(int K, unsigned int pos, float *maxv, unsigned int *maxvpos, rsheader_t *rshd) {
-    int i;
-    int mp = -1;
-    float mx = 0.0;
-    float mx2 = 0.0;
-    float re_cx = 0.0;
-    double xnorm = 1.0;
-    unsigned int mpos = 0;
-
-    float dc = 0.0;
-    rshd->dc = 0.0;
-
-    if (K + rshd->L > N_DFT) return -1;
-//    if (sample_out < rshd->L) return -2; // nur falls K-4 < L
+// alle Header in einem Durchgang:
+// gemeinsames Fenster K+Lw (Lw = max L), Eingangs-Spektrum nur einmal je buf_fm[],
+// FM-lowpass(xn) einmal je (lpIQ,lpFM); dc je Header nur in X[0] bzw. als Offset in xn[].
+// Korrelationen reell: je zwei Header in einer komplexen IDFT (Re, Im).
+static int getCorrDFT(int K, unsigned int pos, int nh, int *idx, float *maxv, unsigned int *maxvpos, int *mpk) {
+    int i, j, n, b, f;
+    int b2, f2;
+    int Lw = 0, W;
+    int mp, L, D;
+    float mx, mx2, re_cx;
+    float dc, c0;
+    double xnorm;
+    unsigned int mpos;
+    rsheader_t *rshd, *rshd2;
+    float *xs;
+    int use[3][2] = {{0}};
+    int bf[6];
+    int nbf = 0;
+
+    if (nh < 1) return 0;
 
     if (pos == 0) pos = sample_out;
 
-    bufs = buf_fm[rshd->lpIQ];
-
-    for (i = 0; i < K+rshd->L; i++) xn[i] = bufs[(pos+M -(K+rshd->L-1) + i) % M];
-    while (i < N_DFT) xn[i++] = 0.0;
-
-    dft(xn, X);
-
-
-    //dc = get_bufmu(pos-sample_out); //oder: dc = creal(X[0])/(K+rshd->L) = avg(xn) // zu lang (M10)
-
-    dc = 0.0;
-    if (option_dc) {
-        //X[0] = 0; // all samples in window
-        // L < K
-        for (i=K-rshd->L; i<K+rshd->L;i++) dc += xn[i]; // only last 2L samples (avoid M10 carrier offset)
-        dc /= 2.0*(float)rshd->L;
-        X[0] -= N_DFT*dc  * 0.98;
+    for (n = 0; n < nh; n++) {
+        rshd = rs_hdr+idx[n];
+        if (rshd->L > Lw) Lw = rshd->L;
+    }
+    W = K + Lw;
+    if (W > N_DFT) return -1;
+
+    // FM: buf_fm[0]=buf_fm[1]=buf_fm[2]
+    for (n = 0; n < nh; n++) {
+        rshd = rs_hdr+idx[n];
+        b = option_iq ? rshd->lpIQ : 0;
+        f = option_iq ? rshd->lpFM : 0;
+        if (use[b][0] == 0 && use[b][1] == 0) {
+            for (i = 0; i < W; i++) xb[b][i] = buf_fm[b][(pos+M -(W-1) + i) % M];
+            while (i < N_DFT) xb[b][i++] = 0.0;
+            dft(xb[b], Xb[b]);
+        }
+        if (use[b][f] == 0) { use[b][f] = 1; bf[nbf++] = 2*b+f; }
     }
-    rshd->dc = dc;
 
     if (option_iq) {
-        // FM-lowpass(xn)
-        for (i = 0; i < N_DFT; i++) X[i] *= WS[rshd->lpFM][i];
+        // FM-lowpass(xn), je zwei in einer IDFT
+        for (n = 0; n < nbf; n += 2) {
+            b = bf[n]/2; f = bf[n]%2;
+            if (n+1 < nbf) {
+                b2 = bf[n+1]/2; f2 = bf[n+1]%2;
+                for (i = 0; i < N_DFT; i++) Z[i] = Xb[b][i]*WS[f][i] + I*Xb[b2][i]*WS[f2][i];
+                Nidft(Z, cx);
+                for (i = 0; i < N_DFT; i++) xbf[b2][f2][i] = -cimag(cx[i])/(float)N_DFT;
+            }
+            else {
+                for (i = 0; i < N_DFT; i++) Z[i] = Xb[b][i]*WS[f][i];
+                Nidft(Z, cx);
+            }
+            for (i = 0; i < N_DFT; i++) xbf[b][f][i] = creal(cx[i])/(float)N_DFT;
+        }
     }
 
-    if (option_dc || option_iq) { // mx = mx(xn[]), xn(lowpass, dc)
-        Nidft(X, cx);
-        for (i = 0; i < N_DFT; i++) xn[i] = creal(cx[i])/(float)N_DFT;
-    }
-    for (i = 0; i < N_DFT; i++) Z[i] = X[i] * rshd->Fm[i];
-    Nidft(Z, cx);
-
-
-    // relativ Peak - Normierung erst zum Schluss;
-    // dann jedoch nicht zwingend corr-Max wenn FM-Amplitude bzw. norm(x) nicht konstant
-    // (z.B. rs41 Signal-Pausen). Moeglicherweise wird dann wahres corr-Max in dem
-    //  K-Fenster nicht erkannt, deshalb K nicht zu gross waehlen.
-    //
-    mx2 = 0.0;                                 // t = L-1
-    for (i = rshd->L-1; i < K+rshd->L; i++) {  // i=t .. i=t+K < t+1+K
-        re_cx = creal(cx[i]);  // imag(cx)=0
-        //if (fabs(re_cx) > fabs(mx)) {
-        if (re_cx*re_cx > mx2) {
-            mx = re_cx;
-            mx2 = mx*mx;
-            mp = i;
+    // dc: nur X[0] bzw. konstanter Offset, Fenster [K-L, K+L) wie bisher
+    for (n = 0; n < nh; n++) {
+        rshd = rs_hdr+idx[n];
+        dc = 0.0;
+        if (option_dc) {
+            b = option_iq ? rshd->lpIQ : 0;
+            D = Lw - rshd->L;
+            for (i = K-rshd->L; i < K+rshd->L; i++) dc += xb[b][D+i]; // only last 2L samples (avoid M10 carrier offset)
+            dc /= 2.0*(float)rshd->L;
         }
+        rshd->dc = dc;
     }
-    if (mp == rshd->L-1 || mp == K+rshd->L-1) return -4; // Randwert
-    //  mp == t            mp == K+t
 
-    mpos = pos - (K + rshd->L-1) + mp; // t = L-1
+    for (n = 0; n < nh; n += 2) {
+        rshd = rs_hdr+idx[n];
+        rshd2 = (n+1 < nh) ? rs_hdr+idx[n+1] : NULL;
+        b = option_iq ? rshd->lpIQ : 0;
+        f = rshd->lpFM;
+        if (rshd2) {
+            b2 = option_iq ? rshd2->lpIQ : 0;
+            f2 = rshd2->lpFM;
+            if (option_iq) {
+                for (i = 0; i < N_DFT; i++) {
+                    Z[i] = Xb[b][i]*WS[f][i]*rshd->Fm[i] + I*Xb[b2][i]*WS[f2][i]*rshd2->Fm[i];
+                }
+                Z[0] = (Xb[b][0]-N_DFT*rshd->dc*0.98)*WS[f][0]*rshd->Fm[0]
+                   + I*(Xb[b2][0]-N_DFT*rshd2->dc*0.98)*WS[f2][0]*rshd2->Fm[0];
+            }
+            else {
+                for (i = 0; i < N_DFT; i++) Z[i] = Xb[b][i]*rshd->Fm[i] + I*Xb[b2][i]*rshd2->Fm[i];
+                Z[0] = (Xb[b][0]-N_DFT*rshd->dc*0.98)*rshd->Fm[0]
+                   + I*(Xb[b2][0]-N_DFT*rshd2->dc*0.98)*rshd2->Fm[0];
+            }
+        }
+        else {
+            if (option_iq) {
+                for (i = 0; i < N_DFT; i++) Z[i] = Xb[b][i]*WS[f][i]*rshd->Fm[i];
+                Z[0] = (Xb[b][0]-N_DFT*rshd->dc*0.98)*WS[f][0]*rshd->Fm[0];
+            }
+            else {
+                for (i = 0; i < N_DFT; i++) Z[i] = Xb[b][i]*rshd->Fm[i];
+                Z[0] = (Xb[b][0]-N_DFT*rshd->dc*0.98)*rshd->Fm[0];
+            }
+        }
+        Nidft(Z, cx);
+        for (i = Lw-1; i < W; i++) {
+            xcorr[0][i] = creal(cx[i]);
+            xcorr[1][i] = -cimag(cx[i]);  // imag(cx)=0 je Header
+        }
+
+        for (j = 0; j < 2 && n+j < nh; j++) {
+            rshd = rs_hdr+idx[n+j];
+            L = rshd->L;
+            D = Lw - L;
+            b = option_iq ? rshd->lpIQ : 0;
+            f = rshd->lpFM;
+
+            // relativ Peak - Normierung erst zum Schluss;
+            // dann jedoch nicht zwingend corr-Max wenn FM-Amplitude bzw. norm(x) nicht konstant
+            // (z.B. rs41 Signal-Pausen). Moeglicherweise wird dann wahres corr-Max in dem
+            //  K-Fenster nicht erkannt, deshalb K nicht zu gross waehlen.
+            //
+            mp = -1;
+            mx = 0.0;
+            mx2 = 0.0;                       // t = Lw-1
+            for (i = Lw-1; i < W; i++) {     // i=t .. i=t+K < t+1+K
+                re_cx = xcorr[j][i];
+                if (re_cx*re_cx > mx2) {
+                    mx = re_cx;
+                    mx2 = mx*mx;
+                    mp = i;
+                }
+            }
+            if (mp == Lw-1 || mp == W-1) { mpk[idx[n+j]] = -4; continue; } // Randwert
+            //  mp == t            mp == K+t
+
+            mpos = pos - (W-1) + mp; // t = Lw-1
+
+            // xn(lowpass, dc)
+            xs = option_iq ? xbf[b][f] : xb[b];
+            c0 = 0.98*rshd->dc;
+            if (option_iq) c0 *= creal(WS[f][0]);
+            xnorm = 0.0;
+            for (i = 0; i < L; i++) xnorm += (xs[mp-i]-c0)*(xs[mp-i]-c0);
+            xnorm = sqrt(xnorm);
 
-    xnorm = 0.0;
-    for (i = 0; i < rshd->L; i++) xnorm += xn[mp-i]*xn[mp-i];
-    xnorm = sqrt(xnorm);
+            mx /= xnorm*N_DFT;
 
-    mx /= xnorm*N_DFT;
+            if (option_iq) mpos -= dsp__lpFMtaps/2;  // lowpass delay
 
-    if (option_iq) mpos -= dsp__lpFMtaps/2;  // lowpass delay
+            maxv[idx[n+j]] = mx;
+            maxvpos[idx[n+j]] = mpos;
 
-    *maxv = mx;
-    *maxvpos = mpos;
+            if (option_dc) {
+                rshd->df = rshd->dc / (2.0*FM_GAIN*dsp__decM);  // freq offset estimate
+            }
 
-    if (option_dc) {
-        rshd->df = rshd->dc / (2.0*FM_GAIN*dsp__decM);  // freq offset estimate
+            mpk[idx[n+j]] = mp - D; // mp(L)
+        }
     }
 
-    return mp;
+    return nh;
 }
 
 /* ------------------------------------------------------------------------------------ */
@@ -1113,6 +1194,19 @@ static int init_buffers() {
     Z  = calloc(N_DFT+1, sizeof(float complex));  if (Z  == NULL) return -1;
     cx = calloc(N_DFT+1, sizeof(float complex));  if (cx == NULL) return -1;
 
+    for (j = 0; j < 3; j++) {
+        xb[j] = calloc(N_DFT+1, sizeof(float));  if (xb[j] == NULL) return -1;
+        Xb[j] = calloc(N_DFT+1, sizeof(float complex));  if (Xb[j] == NULL) return -1;
+        if (option_iq) {
+            for (i = 0; i < 2; i++) {
+                xbf[j][i] = calloc(N_DFT+1, sizeof(float));  if (xbf[j][i] == NULL) return -1;
+            }
+        }
+    }
+    for (j = 0; j < 2; j++) {
+        xcorr[j] = calloc(N_DFT+1, sizeof(float));  if (xcorr[j] == NULL) return -1;
+    }
+
     for (n = 0; n < LOG2N; n++) {
         k = 1 << n;
         ew[n] = cexp(-I*M_PI/(float)k);
@@ -1181,7 +1275,7 @@ static int init_buffers() {
 }
 
 static int free_buffers() {
-    int j;
+    int j, k;
 
     for (j = 0; j < 3; j++) {
         if (buf_fm[j])  { free(buf_fm[j]);  buf_fm[j]  = NULL; }
@@ -1196,6 +1290,17 @@ static int free_buffers() {
     if (Z)  { free(Z);  Z  = NULL; }
     if (cx) { free(cx); cx = NULL; }
 
+    for (j = 0; j < 3; j++) {
+        if (xb[j]) { free(xb[j]); xb[j] = NULL; }
+        if (Xb[j]) { free(Xb[j]); Xb[j] = NULL; }
+        for (k = 0; k < 2; k++) {
+            if (xbf[j][k]) { free(xbf[j][k]); xbf[j][k] = NULL; }
+        }
+    }
+    for (j = 0; j < 2; j++) {
+        if (xcorr[j]) { free(xcorr[j]); xcorr[j] = NULL; }
+    }
+
     for (j = 0; j < idxRS; j++) {
         if (rs_hdr[j].Fm) { free(rs_hdr[j].Fm); rs_hdr[j].Fm = NULL; }
     }
@@ -1241,6 +1346,7 @@ int main(int argc, char **argv) {
     float mv[Nrs];
     unsigned int mv_pos[Nrs], mv0_pos[Nrs];
     int mp[Nrs];
+    int idx[Nrs], nh;
 
     int header_found = 0;
     int herrs;
@@ -1382,6 +1488,7 @@ int main(int argc, char **argv) {
         k += 1;
 
         if (k >= K-4) {
+            nh = 0;
             for (j = 0; j <= idxIMETafsk; j++) { // incl. IMET-preamble
 
                 #ifdef NOC34C50
@@ -1389,8 +1496,9 @@ int main(int argc, char **argv) {
                 #endif
 
                 mv0_pos[j] = mv_pos[j];
-                mp[j] = getCorrDFT(K, 0, mv+j, mv_pos+j, rs_hdr+j);
+                idx[nh++] = j;
             }
+            getCorrDFT(K, 0, nh, idx, mv, mv_pos, mp);
             k = 0;
         }
         else {
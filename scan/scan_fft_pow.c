@@ -22,7 +22,7 @@ static int wav_channel = 0;     // audio channel: left
 static int sample_rate = 0, bits_sample = 0, channels = 0;
 static int wav_ch = 0;  // 0: links bzw. mono; 1: rechts
 
-static unsigned int sample;
+static unsigned long sample;
 
 static float complex *buffer  = NULL;
 
@@ -36,7 +36,8 @@ typedef struct {
     int N;
     int N2;
     float *xn;
-    float complex  *ew;
+    int *brv;
+    float complex  *tw;
     float complex  *Fm;
     float complex  *X;
     float complex  *Z;
@@ -47,41 +48,51 @@ typedef struct {
 
 static dft_t DFT;
 
-static float *avg_rZ, *avg_db, *intdb;
+static float *avg_pw, *avg_db, *intdb;
 static float *avg, *peak;
+static float *bufavg, *tmp_db;
 
+
+/* ------------------------------------------------------------------------------------ */
+// Welch: Hann windowed FFTs, overlap N2-hop, |Z|^2 (linear) accumulated,
+// one spectrum per navg FFTs, output: peak hold (max) over nhold spectra
+
+typedef struct {
+    int hop;      // new samples per FFT
+    int navg;     // FFTs per spectrum
+    int nhold;    // spectra per output
+    int cnt;
+    int hcnt;
+    float *acc;   // sum |Z|^2
+} welch_t;
+
+static welch_t WL;
+
+
+// bit reversal / twiddle tables, stage l2: tw[l2-1+j] = exp(-I*pi*j/l2)
 static void raw_dft(dft_t *dft, float complex *Z) {
-    int s, l, l2, i, j, k;
-    float complex  w1, w2, T;
+    int l, l2, i, j, k;
+    float complex  *w, T;
 
-    j = 1;
-    for (i = 1; i < dft->N; i++) {
+    for (i = 0; i < dft->N; i++) {
+        j = dft->brv[i];
         if (i < j) {
-            T = Z[j-1];
-            Z[j-1] = Z[i-1];
-            Z[i-1] = T;
-        }
-        k = dft->N/2;
-        while (k < j) {
-            j = j - k;
-            k = k/2;
+            T = Z[j];
+            Z[j] = Z[i];
+            Z[i] = T;
         }
-        j = j + k;
     }
 
-    for (s = 0; s < dft->LOG2N; s++) {
-        l2 = 1 << s;
+    for (l2 = 1; l2 < dft->N; l2 <<= 1) {
         l  = l2 << 1;
-        w1 = (float complex)1.0;
-        w2 = dft->ew[s]; // cexp(-I*M_PI/(float)l2)
-        for (j = 1; j <= l2; j++) {
-            for (i = j; i <= dft->N; i += l) {
-                k = i + l2;
-                T = Z[k-1] * w1;
-                Z[k-1] = Z[i-1] - T;
-                Z[i-1] = Z[i-1] + T;
+        w = dft->tw + l2-1;
+        for (i = 0; i < dft->N; i += l) {
+            for (j = 0; j < l2; j++) {
+                k = i + j;
+                T = Z[k+l2] * w[j];
+                Z[k+l2] = Z[k] - T;
+                Z[k]    = Z[k] + T;
             }
-            w1 = w1 * w2;
         }
     }
 }
@@ -165,7 +176,7 @@ static void db_power(dft_t *dft, float complex Z[], float db[]) {  // iq-samples
 
 
 static int init_dft(dft_t *dft) {
-    int i, k, n;
+    int i, j, k, l2;
     float normM = 0;
     int bytes_sample = bits_sample/8;
 
@@ -174,7 +185,8 @@ static int init_dft(dft_t *dft) {
 
     dft->xn = calloc(dft->N+1,   sizeof(float complex));  if (dft->xn == NULL) return -1;
     dft->Z  = calloc(dft->N+1,   sizeof(float complex));  if (dft->Z  == NULL) return -1;
-    dft->ew = calloc(dft->LOG2N, sizeof(float complex));  if (dft->ew == NULL) return -1;
+    dft->brv = calloc(dft->N+1,  sizeof(int));  if (dft->brv == NULL) return -1;
+    dft->tw  = calloc(dft->N+1,  sizeof(float complex));  if (dft->tw  == NULL) return -1;
 
     dft->win = calloc(dft->N+1, sizeof(float complex)); if (dft->win == NULL) return -1;
     dft->N2 = dft->N;
@@ -184,16 +196,24 @@ static int init_dft(dft_t *dft) {
     for (i = 0; i < dft->N2; i++)  normM += dft->win[i]*dft->win[i];
     //normM = sqrt(normM);
 
-    for (n = 0; n < dft->LOG2N; n++) {
-        k = 1 << n;
-        dft->ew[n] = cexp(-I*M_PI/(double)k);
+    for (i = 0; i < dft->N; i++) {
+        j = 0;
+        for (k = 0; k < dft->LOG2N; k++) j |= ((i >> k) & 1) << (dft->LOG2N-1-k);
+        dft->brv[i] = j;
+    }
+    for (l2 = 1; l2 < dft->N; l2 <<= 1) {
+        for (j = 0; j < l2; j++) dft->tw[l2-1+j] = cexp(-I*M_PI*j/(double)l2);
     }
 
-    avg_rZ = calloc(dft->N+1, sizeof(float));  if (avg_rZ == NULL) return -1;
+    avg_pw = calloc(dft->N+1, sizeof(float));  if (avg_pw == NULL) return -1;
     avg_db = calloc(dft->N+1, sizeof(float));  if (avg_db == NULL) return -1;
     intdb  = calloc(dft->N+1, sizeof(float));  if (intdb == NULL) return -1;
     avg    = calloc(dft->N+1, sizeof(float));  if (avg == NULL) return -1;
     peak   = calloc(dft->N+1, sizeof(float));  if (peak == NULL) return -1;
+    bufavg = calloc(dft->N+1, sizeof(float));  if (bufavg == NULL) return -1;
+    tmp_db = calloc(dft->N+1, sizeof(float));  if (tmp_db == NULL) return -1;
+
+    WL.acc = calloc(dft->N+1, sizeof(float));  if (WL.acc == NULL) return -1;
 
     return 0;
 }
@@ -204,13 +224,17 @@ static void end_dft(dft_t *dft) {
     if (buffer) { free(buffer); buffer = NULL; }
     if (dft->xn)  { free(dft->xn);  dft->xn  = NULL; }
     if (dft->Z)   { free(dft->Z);   dft->Z   = NULL; }
-    if (dft->ew)  { free(dft->ew);  dft->ew  = NULL; }
+    if (dft->brv) { free(dft->brv); dft->brv = NULL; }
+    if (dft->tw)  { free(dft->tw);  dft->tw  = NULL; }
     if (dft->win) { free(dft->win); dft->win = NULL; }
-    if (avg_rZ) { free(avg_rZ); avg_rZ = NULL; }
+    if (avg_pw) { free(avg_pw); avg_pw = NULL; }
     if (avg_db) { free(avg_db); avg_db = NULL; }
     if (intdb)  { free(intdb);  intdb  = NULL; }
     if (avg)    { free(avg);    avg    = NULL; }
     if (peak)   { free(peak);   peak   = NULL; }
+    if (bufavg) { free(bufavg); bufavg = NULL; }
+    if (tmp_db) { free(tmp_db); tmp_db = NULL; }
+    if (WL.acc) { free(WL.acc); WL.acc = NULL; }
 }
 
 
@@ -282,56 +306,80 @@ static int read_wav_header(FILE *fp, int wav_channel) {
 }
 
 
-static int read_bufIQ(dft_t *dft, FILE *fp) {
+static int read_bufIQ(dft_t *dft, FILE *fp, int n) {
     int len;
 
-    len = fread( bufIQ, bits_sample/8, 2*dft->N2, fp);
+    len = fread( bufIQ, bits_sample/8, 2*n, fp);
 
-    if ( len != 2*dft->N2) {
-        while (len < 2*dft->N2) {
-            //bufIQ[len] = 0;
-            len++;
-        }
+    if ( len != 2*n) {
         return EOF;
     }
 
     return 0;
 }
 
-static int bufIQ2complex(dft_t *dft) {
+static int bufIQ2complex(dft_t *dft, float complex *buf, int n) {
     int i;
-    float complex z;
+    float *z = (float *)buf;
     unsigned char *buf8;
     short *buf16;
     float *buf32;
 
     if (bits_sample == 8) {
         buf8 = bufIQ;
-        for (i = 0; i < dft->N2; i++) {
-            z = buf8[2*i]-128.0 + I*(buf8[2*i+1]-128.0);
-            z /= 128.0;
-            buffer[i] = z;
-        }
+        for (i = 0; i < 2*n; i++) z[i] = (buf8[i]-128) * (1.0f/128.0f);
     }
     else if (bits_sample == 16) {
         buf16 = bufIQ;
-        for (i = 0; i < dft->N2; i++) {
-            z = buf16[2*i] + I*buf16[2*i+1];
-            z /= 128.0*256.0;
-            buffer[i] = z;
-        }
+        for (i = 0; i < 2*n; i++) z[i] = buf16[i] * (1.0f/32768.0f);
     }
     else { // bits_sample == 32
         buf32 = bufIQ;
-        for (i = 0; i < dft->N2; i++) {
-            z = buf32[2*i] + I*buf32[2*i+1];
-            buffer[i] = z;
-        }
+        memcpy(z, buf32, 2*n*sizeof(float));
     }
 
     return 0;
 }
 
+// frame buffer[0..N2-1] -> WL.acc
+static void welch_fft(dft_t *dft, welch_t *wl) {
+    int j;
+    float complex dc = 0;
+
+    for (j = 0; j < dft->N2; j++) dc += buffer[j];
+    dc /= 0.99*dft->N;
+
+    for (j = 0; j < dft->N2; j++) dft->Z[j] = (buffer[j] - dc) * crealf(dft->win[j]);
+    while (j < dft->N) dft->Z[j++] = 0.0;
+
+    raw_dft(dft, dft->Z);
+
+    for (j = 0; j < dft->N; j++) {
+        float re = crealf(dft->Z[j]), im = cimagf(dft->Z[j]);
+        wl->acc[j] += re*re + im*im;
+    }
+    wl->cnt++;
+}
+
+// avg_pw: avg(|Z|^2)/N^2, peak hold; 1: output ready
+static int welch_avg(dft_t *dft, welch_t *wl) {
+    int j;
+    float a, nrm;
+
+    if (wl->cnt == 0) return 0;
+    nrm = 1.0f / ((float)dft->N*dft->N*wl->cnt);
+    for (j = 0; j < dft->N; j++) {
+        a = wl->acc[j] * nrm;
+        if (wl->hcnt == 0 || a > avg_pw[j]) avg_pw[j] = a;
+        wl->acc[j] = 0.0f;
+    }
+    wl->cnt = 0;
+    wl->hcnt++;
+    if (wl->hcnt < wl->nhold) return 0;
+    wl->hcnt = 0;
+    return 1;
+}
+
 static int f32read_sample(FILE *fp, float *s) {
     int i;
     unsigned int word = 0;
@@ -362,6 +410,148 @@ static int f32read_sample(FILE *fp, float *s) {
 
 /* ------------------------------------------------------------------------------------ */
 
+static int cmp_float(const void *a, const void *b) {
+    float x = *(const float *)a, y = *(const float *)b;
+    return (x > y) - (x < y);
+}
+
+// avg_pw -> peaks (OUT), fpout: db.txt
+static int pow_peaks(dft_t *dft, FILE *OUT, FILE *fpout, int cont) {
+    int j, n, k;
+    float dx;
+    int dn;
+    float dev = 0.0;
+    float sympeak = 0.0;
+    float sympeak2 = 0.0;
+    float globmin = 0.0;
+    float globavg = 0.0;
+    float floor_db = 0.0;
+    int num = 0;
+
+    globmin = 0.0;
+    globavg = 0.0;
+    float db_spike3 = 10.0;
+    int spike_wl3 = 3; //freq2bin(dft, 200); // 3 // 200 Hz
+    int spike_wl5 = 5; //freq2bin(dft, 200); // 3 // 200 Hz
+    float db_spike1 = 15.0;
+    int spike_wl1 = 1; //freq2bin(dft, 200); // 3 // 200 Hz
+    //fprintf(stderr, "sp_wl: %d\n", spike_wl);
+
+    dx = bin2freq(dft, 1);
+    dn = 2*(int)(2400.0/dx)+1; // (odd/symmetric) integration width: 4800+dx Hz
+    if (option_verbose) fprintf(stderr, "dn = %d\n", dn);
+
+    for (j = 0; j < dft->N; j++) {
+        avg_db[j] = 10.0*log10(avg_pw[j]+1e-40); // dB(avg|FFT|^2)
+    }
+
+    // dc-spike (N-1,)N,0,1(,2): subtract mean/avg
+    // spikes in general:
+    for (j = 0; j < dft->N; j++) {
+        if ( avg_db[j] - avg_db[(j-spike_wl5+dft->N)%dft->N] > db_spike3
+          && avg_db[j] - avg_db[(j-spike_wl3+dft->N)%dft->N] > db_spike3
+          && avg_db[j] - avg_db[(j+spike_wl3+dft->N)%dft->N] > db_spike3
+          && avg_db[j] - avg_db[(j+spike_wl5+dft->N)%dft->N] > db_spike3
+           ) {
+            avg_db[j] = (avg_db[(j-spike_wl3+dft->N)%dft->N]+avg_db[(j+spike_wl3+dft->N)%dft->N])/2.0;
+        }
+    }
+
+    // noise floor: median
+    for (j = 0; j < dft->N; j++) tmp_db[j] = avg_db[j];
+    qsort(tmp_db, dft->N, sizeof(float), cmp_float);
+    floor_db = tmp_db[dft->N/2];
+
+    for (j = 0; j < dft->N; j++) {
+        float sum = 0.0;
+        for (n = j-(dn-1)/2; n <= j+(dn-1)/2; n++) sum += avg_db[(n + dft->N) % dft->N];
+        sum /= (float)dn;
+        intdb[j] = sum;
+        globavg += sum; // <=> avg_db[j];
+        if (sum < globmin) globmin = sum;
+    }
+    globavg /= (float)dft->N;
+
+    if (option_verbose) fprintf(stderr, "avg=%.2f\n", globavg);
+    if (option_verbose) fprintf(stderr, "min=%.2f\n", globmin);
+    if (option_verbose) fprintf(stderr, "floor=%.2f\n", floor_db);
+
+    int dn2 = 2*dn+1;
+    int dn3 = (int)(4000.0/dx); // (odd/symmetric) integration width: +/-4000 Hz
+
+    int delay = (int)(24000.0/dx); // 16000
+    if (delay > dft->N) delay = dft->N;
+    k = 0;
+    int mag = 0;
+    int mag0 = 0;
+    float max_db_loc = 0.0;
+    int   max_db_idx = 0;
+    for (j = dft->N/2; j < dft->N/2 + dft->N; j++) {
+        float x = intdb[(j+delay) % dft->N];
+        float a = 0.0;
+
+        if (fpout) fprintf(fpout, "%9.6f ; %9.1f ; %10.4f", bin2fq(dft, j % dft->N), bin2freq(dft, j % dft->N), avg_db[j % dft->N]);
+        if (fpout) fprintf(fpout, " ; %10.4f", intdb[j % dft->N]);
+
+        a = 0.0;
+        for (n = j-(dn2-1)/2; n <= j+(dn2-1)/2; n++) a += intdb[n % dft->N];
+        a /= (float)dn2;
+        bufavg[k % delay] = a;
+
+        dev = 0.0;
+        for (n = j-(dn2-1)/2; n <= j+(dn2-1)/2; n++) dev += (intdb[n % dft->N]-a)*(intdb[n % dft->N]-a);
+        dev = sqrt(dev/(float)dn2);
+
+
+        sympeak = 0.0;
+        for (n = 1; n <= dn3; n++) {
+        sympeak += (avg_db[(j+n) % dft->N]-globmin)*(avg_db[(j-n + dft->N) % dft->N]-globmin);
+        }
+        sympeak = sqrt(abs(sympeak)/(float)dn3);  // globmin > min
+
+        sympeak2 = 0.0;
+        for (n = 0; n <= (dn2-1)/2; n++) sympeak2 += (intdb[(j+n) % dft->N]-globmin)*(intdb[(j-n + dft->N) % dft->N]-globmin);
+        sympeak2 = sqrt(sympeak2/(2.0*dn2));
+
+        peak[k % delay] = sympeak;
+
+
+        if (fpout) fprintf(fpout, " ; %10.4f ; %10.4f", a-globmin, dev);
+        if (fpout) fprintf(fpout, " ; %10.4f ; %10.4f", sympeak, sympeak2);
+
+        mag = (sympeak - peak[(k+1)%delay])/ 3.0;  // threshold 3.0
+        if ( mag < 0 ) mag = 0;
+        if (fpout) fprintf(fpout, " ; %d", mag);
+
+        if (mag0 > 0 && mag == 0) {
+            if ( fabs(bin2fq(dft, max_db_idx)) < 0.425 ) // 85% bandwidth
+            {
+                if (cont) fprintf(OUT, "peak: %+9.6f = %+9.1fHz ; %5.1f dB\n", bin2fq(dft, max_db_idx), bin2freq(dft, max_db_idx),
+                                       intdb[max_db_idx]-floor_db);
+                else      fprintf(OUT, "peak: %+9.6f = %+9.1fHz\n", bin2fq(dft, max_db_idx), bin2freq(dft, max_db_idx));
+                num++;
+            }
+        }
+        if (mag0 == 0 && mag > 0) {
+            max_db_loc = sympeak;
+            max_db_idx = j % dft->N;
+        }
+        if (mag > 0 && sympeak > max_db_loc) {
+            max_db_loc = sympeak;
+            max_db_idx = j % dft->N;
+        }
+
+        mag0 = mag;
+        if (fpout) fprintf(fpout, "\n");
+
+        k++;
+    }
+
+    return num;
+}
+
+/* ------------------------------------------------------------------------------------ */
+
 
 int main(int argc, char **argv) {
 
@@ -373,17 +563,10 @@ int main(int argc, char **argv) {
 
     int mn = 0; // 0: N = M
 
-    int j, n, k;
+    int j, n;
     float tl = 4.0;
-
-    float dx;
-    int dn;
-    //float avg = 0.0;
-    float dev = 0.0;
-    float sympeak = 0.0;
-    float sympeak2 = 0.0;
-    float globmin = 0.0;
-    float globavg = 0.0;
+    float ovl = 0.5;  // Welch overlap
+    int option_cont = 0;
 
 
 #ifdef CYGWIN
@@ -391,6 +574,9 @@ int main(int argc, char **argv) {
 #endif
     setbuf(stdout, NULL);
 
+    WL.navg = 0;
+    WL.nhold = 1;
+
     prgnam = argv[0];
     ++argv;
     while ((*argv) && (!wavloaded)) {
@@ -398,6 +584,10 @@ int main(int argc, char **argv) {
             fprintf(stderr, "%s [options] audio.wav\n", prgnam);
             fprintf(stderr, "  options:\n");
             //fprintf(stderr, "       -v, --verbose\n");
+            fprintf(stderr, "       -t <sec>       (one spectrum of <sec> seconds, default 4)\n");
+            fprintf(stderr, "       -a <n>         (continuous: spectrum of <n> FFTs -> peaks)\n");
+            fprintf(stderr, "       --hold <m>     (continuous: peak hold over <m> spectra)\n");
+            fprintf(stderr, "       --ovl <p>      (FFT overlap, 0 <= p <= 0.9, default 0.5)\n");
             return 0;
         }
         else if ( (strcmp(*argv, "-v") == 0) || (strcmp(*argv, "--verbose") == 0) ) {
@@ -411,6 +601,26 @@ int main(int argc, char **argv) {
             if (*argv) tl = atof(*argv);
             else return -1;
         }
+        else if ( (strcmp(*argv, "-a") == 0) || (strcmp(*argv, "--avg") == 0) ) {
+            ++argv;
+            if (*argv) WL.navg = atoi(*argv);
+            else return -1;
+            if (WL.navg < 1) WL.navg = 1;
+            option_cont = 1;
+        }
+        else if   (strcmp(*argv, "--hold") == 0) {
+            ++argv;
+            if (*argv) WL.nhold = atoi(*argv);
+            else return -1;
+            if (WL.nhold < 1) WL.nhold = 1;
+        }
+        else if   (strcmp(*argv, "--ovl") == 0) {
+            ++argv;
+            if (*argv) ovl = atof(*argv);
+            else return -1;
+            if (ovl < 0.0) ovl = 0.0;
+            if (ovl > 0.9) ovl = 0.9;
+        }
         else {
             if (strcmp(*argv, "-") == 0) {
                 if (argv[1] == NULL) return -1; else sample_rate = atoi(argv[1]);
@@ -468,51 +678,20 @@ int main(int argc, char **argv) {
     DFT.N = DFT.N2 << mn;
     DFT.LOG2N += mn;
 
-    init_dft(&DFT);
-
-    if (option_verbose) fprintf(stderr, "M: %d\n", DFT.N2);
-
-
-    //memset(avg_db, 0, N*sizeof(float)); // calloc()
+    if (init_dft(&DFT) < 0) return -1;
 
-    sample = 0;
-    n = 0;
-    while ( read_bufIQ(&DFT, fp) != EOF ) {
-
-        bufIQ2complex(&DFT);
-        sample += DFT.N2;
-
-        if (sample % DFT.N2 == 0)
-        {
-            double complex dc = 0;
-            for (j = 0; j < DFT.N; j++) {
-                DFT.Z[j] = buffer[j % DFT.N];
-                dc += DFT.Z[j];
-            }
-            dc /= 0.99*DFT.N;
-            //dc = 0;
+    WL.hop = DFT.N2 - (int)(ovl*DFT.N2);
+    if (WL.hop < 1) WL.hop = 1;
 
-            for (j = 0; j < DFT.N; j++) {
-                DFT.Z[j] = buffer[j % DFT.N] - dc;
-            }
-///*
-            for (j = 0; j < DFT.N2; j++) {
-                DFT.Z[j] *= DFT.win[j];
-            }
-            while (j < DFT.N) DFT.Z[j++] = 0.0;
-//*/
-            raw_dft(&DFT, DFT.Z);
-
-            for (j = 0; j < DFT.N; j++) avg_rZ[j] += cabs(DFT.Z[j]);
+    if (option_verbose) fprintf(stderr, "M: %d\n", DFT.N2);
+    if (option_verbose) fprintf(stderr, "hop: %d\n", WL.hop);
 
-            n++;
 
-            if (sample > tl*DFT.sr) break;
-        }
+    if (option_cont) {
+        OUT = stdout;
+        fpout = NULL;
     }
-    if (option_verbose) fprintf(stderr, "n=%d\n", n);
-
-    if (option_verbose == 0) {
+    else if (option_verbose == 0) {
         OUT = stdout;
         fpout = fopen("db.txt", "wb");
         if (fpout == NULL) return -1;
@@ -522,127 +701,46 @@ int main(int argc, char **argv) {
     }
 
 
-    globmin = 0.0;
-    globavg = 0.0;
-    float db_spike3 = 10.0;
-    int spike_wl3 = 3; //freq2bin(&DFT, 200); // 3 // 200 Hz
-    int spike_wl5 = 5; //freq2bin(&DFT, 200); // 3 // 200 Hz
-    float db_spike1 = 15.0;
-    int spike_wl1 = 1; //freq2bin(&DFT, 200); // 3 // 200 Hz
-    //fprintf(stderr, "sp_wl: %d\n", spike_wl);
-
-    dx = bin2freq(&DFT, 1);
-    dn = 2*(int)(2400.0/dx)+1; // (odd/symmetric) integration width: 4800+dx Hz
-    if (option_verbose) fprintf(stderr, "dn = %d\n", dn);
-
-    for (j = 0; j < DFT.N; j++) {
-        avg_rZ[j] /= DFT.N*(float)n; // avg(FFT)
-        avg_db[j] = 20.0*log10(avg_rZ[j]+1e-20); // dB(avgFFT)
-    }
-
-    // dc-spike (N-1,)N,0,1(,2): subtract mean/avg
-    // spikes in general:
-    for (j = 0; j < DFT.N; j++) {
-        if ( avg_db[j] - avg_db[(j-spike_wl5+DFT.N)%DFT.N] > db_spike3
-          && avg_db[j] - avg_db[(j-spike_wl3+DFT.N)%DFT.N] > db_spike3
-          && avg_db[j] - avg_db[(j+spike_wl3+DFT.N)%DFT.N] > db_spike3
-          && avg_db[j] - avg_db[(j+spike_wl5+DFT.N)%DFT.N] > db_spike3
-           ) {
-            avg_db[j] = (avg_db[(j-spike_wl3+DFT.N)%DFT.N]+avg_db[(j+spike_wl3+DFT.N)%DFT.N])/2.0;
-        }
-    }
-
-    for (j = 0; j < DFT.N; j++) {
-        float sum = 0.0;
-        for (n = j-(dn-1)/2; n <= j+(dn-1)/2; n++) sum += avg_db[(n + DFT.N) % DFT.N];
-        sum /= (float)dn;
-        intdb[j] = sum;
-        globavg += sum; // <=> avg_db[j];
-        if (sum < globmin) globmin = sum;
-    }
-    globavg /= (float)DFT.N;
-
-    if (option_verbose) fprintf(stderr, "avg=%.2f\n", globavg);
-    if (option_verbose) fprintf(stderr, "min=%.2f\n", globmin);
-
-    int dn2 = 2*dn+1;
-    int dn3 = (int)(4000.0/dx); // (odd/symmetric) integration width: +/-4000 Hz
-
-    int delay = (int)(24000.0/dx); // 16000
-    float *bufavg = calloc(delay+1, sizeof(float)); if (bufavg == NULL) return -1;
-    float *bufpeak = calloc(delay+1, sizeof(float)); if (bufpeak == NULL) return -1;
-    k = 0;
-    int mag = 0;
-    int mag0 = 0;
-    float max_db_loc = 0.0;
-    int   max_db_idx = 0;
-    for (j = DFT.N/2; j < DFT.N/2 + DFT.N; j++) {
-        float x = intdb[(j+delay) % DFT.N];
-        float a = 0.0;
-
-        if (1 || option_verbose) fprintf(fpout, "%9.6f ; %9.1f ; %10.4f", bin2fq(&DFT, j % DFT.N), bin2freq(&DFT, j % DFT.N), avg_db[j % DFT.N]);
-        if (1 || option_verbose) fprintf(fpout, " ; %10.4f", intdb[j % DFT.N]);
-
-        a = 0.0;
-        for (n = j-(dn2-1)/2; n <= j+(dn2-1)/2; n++) a += intdb[n % DFT.N];
-        a /= (float)dn2;
-        bufavg[k % delay] = a;
-
-        dev = 0.0;
-        for (n = j-(dn2-1)/2; n <= j+(dn2-1)/2; n++) dev += (intdb[n % DFT.N]-a)*(intdb[n % DFT.N]-a);
-        dev = sqrt(dev/(float)dn2);
-
-
-        sympeak = 0.0;
-        for (n = 1; n <= dn3; n++) {
-        sympeak += (avg_db[(j+n) % DFT.N]-globmin)*(avg_db[(j-n + DFT.N) % DFT.N]-globmin);
-        }
-        sympeak = sqrt(abs(sympeak)/(float)dn3);  // globmin > min
-
-        sympeak2 = 0.0;
-        for (n = 0; n <= (dn2-1)/2; n++) sympeak2 += (intdb[(j+n) % DFT.N]-globmin)*(intdb[(j-n + DFT.N) % DFT.N]-globmin);
-        sympeak2 = sqrt(sympeak2/(2.0*dn2));
-
-        peak[k % delay] = sympeak;
+    // Welch: buffer[] sliding frame, memory fixed
+    sample = 0;
+    n = 0;
+    if ( read_bufIQ(&DFT, fp, DFT.N2) != EOF ) {
 
+        bufIQ2complex(&DFT, buffer, DFT.N2);
+        sample += DFT.N2;
 
-        if (1 || option_verbose) fprintf(fpout, " ; %10.4f ; %10.4f", a-globmin, dev);
-        if (1 || option_verbose) fprintf(fpout, " ; %10.4f ; %10.4f", sympeak, sympeak2);
+        while ( 1 ) {
 
-        mag = (sympeak - peak[(k+1)%delay])/ 3.0;  // threshold 3.0
-        if ( mag < 0 ) mag = 0;
-        if (1 || option_verbose) fprintf(fpout, " ; %d", mag);
+            welch_fft(&DFT, &WL);
+            n++;
 
-        if (mag0 > 0 && mag == 0) {
-            if ( fabs(bin2fq(&DFT, max_db_idx)) < 0.425 ) // 85% bandwidth
-            {
-                fprintf(OUT, "peak: %+9.6f = %+9.1fHz\n", bin2fq(&DFT, max_db_idx), bin2freq(&DFT, max_db_idx));
+            if (option_cont) {
+                if (WL.cnt == WL.navg && welch_avg(&DFT, &WL)) {
+                    fprintf(OUT, "# %.1f s\n", sample/(double)DFT.sr);
+                    pow_peaks(&DFT, OUT, NULL, 1);
+                }
             }
-        }
-        if (mag0 == 0 && mag > 0) {
-            max_db_loc = sympeak;
-            max_db_idx = j % DFT.N;
-        }
-        if (mag > 0 && sympeak > max_db_loc) {
-            max_db_loc = sympeak;
-            max_db_idx = j % DFT.N;
-        }
+            else if (sample > tl*DFT.sr) break;
 
-        mag0 = mag;
-        if (1 || option_verbose) fprintf(fpout, "\n");
+            memmove(buffer, buffer+WL.hop, (DFT.N2-WL.hop)*sizeof(float complex));
+            if ( read_bufIQ(&DFT, fp, WL.hop) == EOF ) break;
+            bufIQ2complex(&DFT, buffer+DFT.N2-WL.hop, WL.hop);
+            sample += WL.hop;
+        }
+    }
+    if (option_verbose) fprintf(stderr, "n=%d\n", n);
 
-        k++;
+    if (!option_cont) {
+        WL.nhold = 1;
+        if (welch_avg(&DFT, &WL)) pow_peaks(&DFT, OUT, fpout, 0);
+        if (option_verbose == 0 && fpout) fclose(fpout);
     }
 
     if (option_verbose) fprintf(stderr, "bin = %.2f Hz\n", bin2freq(&DFT, 1));
 
-    if (bufavg) free(bufavg);
-    if (bufpeak) free(bufpeak);
-
     end_dft(&DFT);
     fclose(fp);
 
 
     return 0;
 }
-